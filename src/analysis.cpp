@@ -0,0 +1,141 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Parses Stockfish search output into structured results
+*/
+
+#include "analysis.h"
+#include "metrics.h"
+#include "uci_engine.h"
+
+#include <charconv>
+
+namespace
+{
+    // Splits off the next space-separated token
+    // Input: remaining text (advanced past the token)
+    // Output: token, empty at end of line
+    std::string_view nextToken(std::string_view& rest)
+    {
+        size_t start = rest.find_first_not_of(' ');
+        if (start == std::string_view::npos)
+        {
+            rest = {};
+            return {};
+        }
+        rest.remove_prefix(start);
+        size_t end = rest.find(' ');
+        std::string_view token = rest.substr(0, end);
+        rest.remove_prefix(end == std::string_view::npos ? rest.size() : end);
+        return token;
+    }
+
+    template <typename T>
+    T toNumber(std::string_view s)
+    {
+        T value = 0;
+        std::from_chars(s.data(), s.data() + s.size(), value);
+        return value;
+    }
+}
+
+// Updates result from an "info ..." line; ignores lines without a score
+// Input: engine line, result to update
+// Output: true if the line carried search progress
+bool parseInfoLine(std::string_view line, SearchResult& result)
+{
+    std::string_view rest = line;
+    if (nextToken(rest) != "info")
+        return false;
+
+    // only the main line counts; currmove/string lines carry no score
+    SearchResult next = result;
+    bool scored = false;
+    for (std::string_view tok = nextToken(rest); !tok.empty(); tok = nextToken(rest))
+    {
+        if (tok == "string")
+            return false;
+        else if (tok == "multipv")
+        {
+            if (toNumber<int>(nextToken(rest)) != 1)
+                return false;
+        }
+        else if (tok == "depth")
+            next.depth = toNumber<int>(nextToken(rest));
+        else if (tok == "seldepth")
+            next.seldepth = toNumber<int>(nextToken(rest));
+        else if (tok == "nodes")
+            next.nodes = toNumber<std::uint64_t>(nextToken(rest));
+        else if (tok == "nps")
+            next.nps = toNumber<std::uint64_t>(nextToken(rest));
+        else if (tok == "hashfull")
+            next.hashfull = toNumber<int>(nextToken(rest));
+        else if (tok == "tbhits")
+            next.tbhits = toNumber<std::uint64_t>(nextToken(rest));
+        else if (tok == "time")
+            next.timeMs = toNumber<int>(nextToken(rest));
+        else if (tok == "score")
+        {
+            std::string_view kind = nextToken(rest);
+            next.mate = (kind == "mate");
+            next.score = toNumber<int>(nextToken(rest));
+            scored = true;
+        }
+        else if (tok == "pv")
+        {
+            next.pv.clear();
+            for (std::string_view mv = nextToken(rest); !mv.empty(); mv = nextToken(rest))
+                next.pv.emplace_back(mv);
+        }
+    }
+
+    if (!scored)
+        return false;
+    result = std::move(next);
+    return true;
+}
+
+// Reads the moves out of "bestmove e7e8q ponder a2a1"
+// Input: engine line, result to update
+// Output: true if the line was a bestmove line
+bool parseBestMoveLine(std::string_view line, SearchResult& result)
+{
+    std::string_view rest = line;
+    if (nextToken(rest) != "bestmove")
+        return false;
+
+    result.bestmove = std::string(nextToken(rest));
+    if (nextToken(rest) == "ponder")
+        result.ponder = std::string(nextToken(rest));
+    return true;
+}
+
+// Formats the score the way the engine reported it
+// Input: SearchResult
+// Output: string like "cp 23" or "mate -3"
+std::string formatScore(const SearchResult& result)
+{
+    return (result.mate ? "mate " : "cp ") + std::to_string(result.score);
+}
+
+// Runs a search and collects the final info and bestmove lines
+// Input: engine, position command, go command, deadline for the reply
+// Output: SearchResult (throws UciError on engine failure)
+SearchResult runSearch(UciEngine& engine, const std::string& position, const std::string& go,
+                       std::chrono::milliseconds timeout)
+{
+    SearchResult result;
+    engine.send(position);
+    const auto start = std::chrono::steady_clock::now();
+    engine.send(go);
+    engine.readLines(timeout, [&](std::string_view line)
+    {
+        if (parseBestMoveLine(line, result))
+            return true;
+        parseInfoLine(line, result);
+        return false;
+    });
+    metrics().recordSearch(result, std::chrono::steady_clock::now() - start);
+    return result;
+}
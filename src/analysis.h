@@ -0,0 +1,54 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Parses Stockfish search output into structured results
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class UciEngine;
+
+// Summary of one finished search
+struct SearchResult
+{
+    std::string bestmove;
+    std::string ponder;
+    bool mate = false;      // score is "mate N" rather than centipawns
+    int score = 0;
+    int depth = 0;
+    int seldepth = 0;
+    std::uint64_t nodes = 0;
+    std::uint64_t nps = 0;
+    int hashfull = 0;       // permille of the hash table in use
+    std::uint64_t tbhits = 0;
+    int timeMs = 0;         // engine-reported search time
+    std::vector<std::string> pv;
+};
+
+// Updates result from an "info ..." line; ignores lines without a score
+// Input: engine line, result to update
+// Output: true if the line carried search progress
+bool parseInfoLine(std::string_view line, SearchResult& result);
+
+// Reads the moves out of "bestmove e7e8q ponder a2a1"
+// Input: engine line, result to update
+// Output: true if the line was a bestmove line
+bool parseBestMoveLine(std::string_view line, SearchResult& result);
+
+// Formats the score the way the engine reported it
+// Input: SearchResult
+// Output: string like "cp 23" or "mate -3"
+std::string formatScore(const SearchResult& result);
+
+// Runs a search and collects the final info and bestmove lines
+// Input: engine, position command, go command, deadline for the reply
+// Output: SearchResult (throws UciError on engine failure)
+SearchResult runSearch(UciEngine& engine, const std::string& position, const std::string& go,
+                       std::chrono::milliseconds timeout);
@@ -0,0 +1,262 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Memory-mapped analysis cache keyed by Zobrist hash, shared between processes
+*/
+
+#include "analysis_cache.h"
+#include "position.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char FileMagic[8] = {'C', 'H', 'S', 'C', 'A', 'C', 'H', 'E'};
+    // 2: keys carry the engine profile; version 1 files may mix weakened and full-strength results
+    const std::uint32_t Version = 2;
+    const std::size_t HeaderSize = 64;
+    const int MaxPv = 24;
+
+    struct FileHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t slotSize;
+        std::uint64_t slotCount;
+    };
+
+    // Mixes the payload words so that any torn or stale write fails the key check
+    std::uint64_t checksum(const std::uint64_t* payload, int count)
+    {
+        std::uint64_t h = 0x9E3779B97F4A7C15ULL;
+        for (int i = 0; i < count; i++)
+        {
+            h = (h ^ payload[i]) * 0xBF58476D1CE4E5B9ULL;
+            h ^= h >> 31;
+        }
+        return h;
+    }
+
+    // Packs a UCI move string into the 16-bit Move layout without needing a position
+    Move encodeUci(const std::string& uci)
+    {
+        if (uci.size() < 4 || uci[0] < 'a' || uci[0] > 'h' || uci[2] < 'a' || uci[2] > 'h')
+            return NoMove;
+
+        PieceType promo = NoPieceType;
+        if (uci.size() > 4)
+        {
+            switch (uci[4])
+            {
+                case 'n': promo = Knight; break;
+                case 'b': promo = Bishop; break;
+                case 'r': promo = Rook; break;
+                case 'q': promo = Queen; break;
+                default: break;
+            }
+        }
+        return makeMove(makeSquare(uci[0] - 'a', uci[1] - '1'), makeSquare(uci[2] - 'a', uci[3] - '1'), promo);
+    }
+
+    int depthOf(std::uint64_t meta) { return int(meta & 0xFF); }
+
+    // FNV-1a, spread so that profiles differing in one character land far apart
+    std::uint64_t hashProfile(const std::string& profile)
+    {
+        if (profile.empty())
+            return 0;
+        std::uint64_t h = 0xCBF29CE484222325ULL;
+        for (unsigned char c : profile)
+            h = (h ^ c) * 0x100000001B3ULL;
+        return h * 0x9E3779B97F4A7C15ULL;
+    }
+}
+
+AnalysisCache::~AnalysisCache()
+{
+    close();
+}
+
+// Maps the cache file, creating it with the requested size if needed
+// Input: file path, size in MB for a new file (an existing file keeps its size), engine options
+//        that weaken its play (empty at full strength)
+// Output: false if the file cannot be created or has an incompatible layout
+bool AnalysisCache::open(const std::string& path, std::size_t sizeMB, const std::string& profile)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "Cannot open analysis cache " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    // the lock only covers creation and validation; slot access never takes it
+    flock(fd, LOCK_EX);
+
+    FileHeader header{};
+    struct stat st{};
+    bool ok = fstat(fd, &st) == 0;
+    if (ok && st.st_size == 0)
+    {
+        std::uint64_t count = 1;
+        while (count * 2 * sizeof(Slot) <= sizeMB * 1024 * 1024)
+            count *= 2;
+        count = std::max<std::uint64_t>(count, ProbeLength);
+
+        std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+        header.version = Version;
+        header.slotSize = sizeof(Slot);
+        header.slotCount = count;
+        ok = ftruncate(fd, off_t(HeaderSize + count * sizeof(Slot))) == 0
+          && pwrite(fd, &header, sizeof(header), 0) == ssize_t(sizeof(header));
+    }
+    else if (ok)
+    {
+        ok = pread(fd, &header, sizeof(header), 0) == ssize_t(sizeof(header))
+          && std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) == 0
+          && header.version == Version
+          && header.slotSize == sizeof(Slot)
+          && header.slotCount >= ProbeLength
+          && (header.slotCount & (header.slotCount - 1)) == 0
+          && std::uint64_t(st.st_size) == HeaderSize + header.slotCount * sizeof(Slot);
+    }
+
+    if (ok)
+    {
+        mappingSize = HeaderSize + header.slotCount * sizeof(Slot);
+        mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            mapping = nullptr;
+            ok = false;
+        }
+    }
+
+    flock(fd, LOCK_UN);
+    ::close(fd);
+
+    if (!ok)
+    {
+        std::cerr << "Analysis cache " << path << " is unusable\n";
+        return false;
+    }
+
+    slots = reinterpret_cast<Slot*>(static_cast<char*>(mapping) + HeaderSize);
+    slotMask = header.slotCount - 1;
+    profileKey = hashProfile(profile);
+    return true;
+}
+
+// Unmaps the file
+void AnalysisCache::close()
+{
+    if (mapping)
+        munmap(mapping, mappingSize);
+    mapping = nullptr;
+    slots = nullptr;
+    mappingSize = 0;
+    slotMask = 0;
+    profileKey = 0;
+}
+
+// Looks up a position
+// Input: Zobrist key, result to fill
+// Output: true on a hit (bestmove, score, depth and pv are set)
+bool AnalysisCache::probe(std::uint64_t key, SearchResult& result) const
+{
+    if (!slots)
+        return false;
+
+    key ^= profileKey;
+    for (int i = 0; i < ProbeLength; i++)
+    {
+        const Slot& slot = slots[(key + i) & slotMask];
+
+        std::uint64_t payload[SlotWords - 1];
+        for (int w = 1; w < SlotWords; w++)
+            payload[w - 1] = slot.words[w].load(std::memory_order_relaxed);
+        std::uint64_t check = slot.words[0].load(std::memory_order_relaxed);
+
+        std::uint64_t meta = payload[0];
+        if (meta == 0 || (check ^ checksum(payload, SlotWords - 1)) != key)
+            continue;
+
+        result = SearchResult();
+        result.depth = depthOf(meta);
+        result.mate = (meta >> 8) & 1;
+        result.score = std::int16_t((meta >> 16) & 0xFFFF);
+        result.bestmove = Position::toUci(Move((meta >> 32) & 0xFFFF));
+
+        int pvLength = int((meta >> 48) & 0x1F);
+        for (int m = 0; m < pvLength; m++)
+            result.pv.push_back(Position::toUci(Move(payload[1 + m / 4] >> (16 * (m % 4)))));
+        if (result.pv.size() > 1)
+            result.ponder = result.pv[1];
+        return true;
+    }
+    return false;
+}
+
+// Records a search, keeping the deeper entry if the position is already stored
+// Input: Zobrist key, finished search
+// Output: None
+void AnalysisCache::store(std::uint64_t key, const SearchResult& result)
+{
+    Move best = encodeUci(result.bestmove);
+    if (!slots || best == NoMove || result.depth < 1)
+        return;
+    key ^= profileKey;
+
+    // prefer the slot already holding this key, then an empty one, then the shallowest
+    Slot* target = nullptr;
+    int targetDepth = 256;
+    for (int i = 0; i < ProbeLength; i++)
+    {
+        Slot& slot = slots[(key + i) & slotMask];
+
+        std::uint64_t payload[SlotWords - 1];
+        for (int w = 1; w < SlotWords; w++)
+            payload[w - 1] = slot.words[w].load(std::memory_order_relaxed);
+        std::uint64_t check = slot.words[0].load(std::memory_order_relaxed);
+
+        if (payload[0] != 0 && (check ^ checksum(payload, SlotWords - 1)) == key)
+        {
+            if (depthOf(payload[0]) > result.depth)
+                return;
+            target = &slot;
+            break;
+        }
+
+        int depth = payload[0] == 0 ? -1 : depthOf(payload[0]);
+        if (depth < targetDepth)
+        {
+            target = &slot;
+            targetDepth = depth;
+        }
+    }
+
+    int pvLength = std::min<int>(int(result.pv.size()), MaxPv);
+    std::uint64_t payload[SlotWords - 1] = {};
+    payload[0] = std::uint64_t(std::min(result.depth, 255))
+               | (std::uint64_t(result.mate) << 8)
+               | (std::uint64_t(std::uint16_t(std::clamp(result.score, -32767, 32767))) << 16)
+               | (std::uint64_t(best) << 32)
+               | (std::uint64_t(pvLength) << 48);
+    for (int m = 0; m < pvLength; m++)
+        payload[1 + m / 4] |= std::uint64_t(encodeUci(result.pv[m])) << (16 * (m % 4));
+
+    for (int w = 1; w < SlotWords; w++)
+        target->words[w].store(payload[w - 1], std::memory_order_relaxed);
+    target->words[0].store(key ^ checksum(payload, SlotWords - 1), std::memory_order_release);
+}
@@ -0,0 +1,68 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Memory-mapped analysis cache keyed by Zobrist hash, shared between processes
+*/
+
+#pragma once
+
+#include "analysis.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Fixed-size open-addressed table stored in a file and mapped into memory.
+// Slots are written without locks; each one carries key ^ checksum(payload), so a
+// reader that races a writer (in any process) sees a mismatch and treats it as a miss.
+class AnalysisCache
+{
+public:
+    AnalysisCache() = default;
+    ~AnalysisCache();
+
+    AnalysisCache(const AnalysisCache&) = delete;
+    AnalysisCache& operator=(const AnalysisCache&) = delete;
+
+    // Maps the cache file, creating it with the requested size if needed
+    // Input: file path, size in MB for a new file (an existing file keeps its size),
+    //        engine options that weaken its play (e.g. a Skill Level setoption; empty at full
+    //        strength). Entries are keyed by it, so a weakened engine never shares results.
+    // Output: false if the file cannot be created or has an incompatible layout
+    bool open(const std::string& path, std::size_t sizeMB, const std::string& profile = "");
+
+    // Unmaps the file
+    void close();
+
+    bool isOpen() const { return slots != nullptr; }
+
+    // Looks up a position
+    // Input: Zobrist key, result to fill
+    // Output: true on a hit (bestmove, score, depth and pv are set)
+    bool probe(std::uint64_t key, SearchResult& result) const;
+
+    // Records a search, keeping the deeper entry if the position is already stored
+    // Input: Zobrist key, finished search
+    // Output: None
+    void store(std::uint64_t key, const SearchResult& result);
+
+private:
+    static constexpr int SlotWords = 8;
+    static constexpr int ProbeLength = 4;
+
+    // word 0: key ^ checksum, word 1: depth/score/bestmove, words 2-7: up to 24 PV moves
+    struct Slot
+    {
+        std::atomic<std::uint64_t> words[SlotWords];
+    };
+    static_assert(sizeof(Slot) == 64, "one slot per cache line");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "slots live in shared memory");
+
+    void* mapping = nullptr;
+    std::size_t mappingSize = 0;
+    Slot* slots = nullptr;
+    std::uint64_t slotMask = 0;
+    std::uint64_t profileKey = 0;   // mixed into every key; 0 at full strength
+};
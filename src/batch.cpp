@@ -0,0 +1,356 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Headless analysis of EPD/FEN files and PGN corpora over a pool of engines
+*/
+
+#include "batch.h"
+#include "analysis_cache.h"
+#include "engine_pool.h"
+#include "pgn.h"
+#include "position.h"
+#include "search_policy.h"
+#include "work_queue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    const std::chrono::milliseconds SearchTimeout(300000);
+
+    // Positions queued per engine before the reader waits
+    const std::size_t QueueDepthPerEngine = 64;
+
+    // Finished lines held back behind one slow position before the reader waits
+    const std::size_t ReorderWindow = 65536;
+
+    // Accepts results in any order and writes them in input order
+    class OrderedWriter
+    {
+    public:
+        explicit OrderedWriter(std::ostream& out) : out(out) {}
+
+        // Input: input index, finished output line
+        // Output: None (writes every line that is now in order)
+        void put(std::size_t index, std::string line)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.emplace(index, std::move(line));
+            const std::size_t before = next;
+            while (!pending.empty() && pending.begin()->first == next)
+            {
+                out << pending.begin()->second << '\n';
+                pending.erase(pending.begin());
+                next++;
+            }
+            if (next != before)
+                room.notify_all();
+        }
+
+        // Blocks the reader until index is within ReorderWindow of the next line to write, so one
+        // stuck position cannot make the buffer grow with the rest of the input
+        // Input: index about to be handed out
+        // Output: None
+        void waitForRoom(std::size_t index)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            room.wait(lock, [&] { return index < next + ReorderWindow; });
+        }
+
+        void flush()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            out.flush();
+        }
+
+    private:
+        std::ostream& out;
+        std::mutex mutex;
+        std::condition_variable room;
+        std::map<std::size_t, std::string> pending;
+        std::size_t next = 0;
+    };
+
+    bool isNumber(const std::string& s)
+    {
+        return !s.empty() && std::all_of(s.begin(), s.end(), [](unsigned char c) { return std::isdigit(c); });
+    }
+}
+
+// Converts an EPD or FEN record to a full six-field FEN
+// Input: one line of the input file
+// Output: FEN string, empty for blank or comment lines
+std::string epdToFen(const std::string& line)
+{
+    std::stringstream ss(line);
+    std::vector<std::string> tokens;
+    std::string token;
+    while (ss >> token)
+        tokens.push_back(token);
+
+    if (tokens.size() < 4 || tokens[0][0] == '#')
+        return "";
+
+    std::string halfmove = "0";
+    std::string fullmove = "1";
+    if (tokens.size() >= 6 && isNumber(tokens[4]) && isNumber(tokens[5]))
+    {
+        halfmove = tokens[4];
+        fullmove = tokens[5];
+    }
+    else
+    {
+        // EPD carries the clocks as "hmvc N;" and "fmvn N;" operations
+        for (std::size_t i = 4; i + 1 < tokens.size(); i++)
+        {
+            std::string value = tokens[i + 1];
+            if (!value.empty() && value.back() == ';')
+                value.pop_back();
+            if (tokens[i] == "hmvc" && isNumber(value))
+                halfmove = value;
+            else if (tokens[i] == "fmvn" && isNumber(value))
+                fullmove = value;
+        }
+    }
+
+    return tokens[0] + " " + tokens[1] + " " + tokens[2] + " " + tokens[3] + " " + halfmove + " " + fullmove;
+}
+
+// Searches every position the source yields across a pool of engines
+// Input: options, source called on this thread until it returns false, result handler
+// Output: number of positions analysed
+std::size_t analyseAll(const BatchOptions& options, const std::function<bool(std::string& fen)>& source,
+                       const BatchResultHandler& onResult)
+{
+    std::size_t engines = options.engines;
+    if (engines == 0)
+        engines = std::max(1u, std::thread::hardware_concurrency());
+
+    // one search thread per engine so the engines, not the threads, share the cores
+    const int hashMB = options.hashMB > 0 ? options.hashMB : recommendedHashMB(engines);
+    EnginePool pool(options.enginePath, engines,
+                    {"setoption name Threads value 1", "setoption name Hash value " + std::to_string(hashMB)});
+    WorkStealingQueue<BatchJob> queue(engines, engines * QueueDepthPerEngine);
+    const std::string go = "go depth " + std::to_string(options.depth);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (std::size_t slot = 0; slot < engines; slot++)
+    {
+        workers.emplace_back([&, slot]
+        {
+            BatchJob job;
+            while (queue.pop(slot, job))
+            {
+                try
+                {
+                    SearchResult r = pool.withEngine(slot, [&](UciEngine& engine)
+                    {
+                        return runSearch(engine, "position fen " + job.fen, go, SearchTimeout);
+                    });
+                    onResult(job, &r, "");
+                }
+                catch (const UciError& e)
+                {
+                    onResult(job, nullptr, e.what());
+                }
+            }
+        });
+    }
+
+    // pull positions lazily so memory stays bounded by the queue, not the input size
+    std::size_t count = 0;
+    std::size_t invalid = 0;
+    std::string fen;
+    while (source(fen))
+    {
+        // a malformed FEN can crash the engine, so it never reaches one
+        Position pos;
+        BatchJob job{count++, std::move(fen)};
+        if (pos.setFen(job.fen))
+            queue.push(std::move(job));
+        else
+        {
+            invalid++;
+            onResult(job, nullptr, "invalid fen");
+        }
+    }
+    queue.close();
+
+    for (std::thread& t : workers)
+        t.join();
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Analysed " << count << " positions with " << engines << " engines in " << secs << " s ("
+              << (secs > 0 ? count / secs : 0.0) << " pos/s, " << invalid << " invalid, " << pool.restarts()
+              << " restarts)\n";
+    return count;
+}
+
+// Analyses every position in the input file and writes results in input order
+// Input: BatchOptions
+// Output: process exit code (1 if the files cannot be opened, 2 if any position failed)
+int runBatch(const BatchOptions& options)
+{
+    std::ifstream in(options.inputPath);
+    if (!in)
+    {
+        std::cerr << "Cannot open " << options.inputPath << "\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!options.outputPath.empty())
+    {
+        file.open(options.outputPath);
+        if (!file)
+        {
+            std::cerr << "Cannot write " << options.outputPath << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.outputPath.empty() ? std::cout : file;
+
+    OrderedWriter writer(out);
+    out << "# fen\tbestmove\tscore\tdepth\tnodes\n";
+
+    // analyseAll numbers the positions in the order this hands them out
+    std::size_t handed = 0;
+    auto nextPosition = [&](std::string& fen)
+    {
+        std::string line;
+        while (std::getline(in, line))
+        {
+            fen = epdToFen(line);
+            if (!fen.empty())
+            {
+                writer.waitForRoom(handed++);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::atomic<std::size_t> errors{0};
+    analyseAll(options, nextPosition, [&](const BatchJob& job, const SearchResult* r, const std::string& error)
+    {
+        std::string line = job.fen + "\t";
+        if (r)
+            line += r->bestmove + "\t" + formatScore(*r) + "\t" + std::to_string(r->depth) + "\t"
+                  + std::to_string(r->nodes);
+        else
+        {
+            line += "error\t" + error;
+            errors++;
+        }
+        writer.put(job.index, std::move(line));
+    });
+
+    writer.flush();
+    if (errors > 0)
+    {
+        std::cerr << errors << " positions failed\n";
+        return 2;
+    }
+    return 0;
+}
+
+// Replays every game of a PGN corpus and stores engine analysis in the cache
+// Input: BatchOptions (inputPath is the PGN file)
+// Output: process exit code
+int runCacheBuild(const BatchOptions& options)
+{
+    std::ifstream in(options.inputPath);
+    if (!in)
+    {
+        std::cerr << "Cannot open " << options.inputPath << "\n";
+        return 1;
+    }
+
+    AnalysisCache cache;
+    if (options.cachePath.empty() || !cache.open(options.cachePath, options.cacheSizeMB))
+        return 1;
+
+    // walk the games lazily, handing out each new position only once
+    PgnReader reader(in);
+    std::unordered_set<std::uint64_t> seen;
+    std::vector<std::string> sanMoves;
+    std::string startFen;
+    std::vector<std::string> pending;
+    std::size_t games = 0;
+    std::size_t skipped = 0;
+    std::size_t terminal = 0;
+
+    auto nextPosition = [&](std::string& fen)
+    {
+        while (pending.empty())
+        {
+            if (!reader.nextGame(startFen, sanMoves))
+                return false;
+            games++;
+
+            Position pos;
+            if (!pos.setFen(startFen))
+                continue;
+
+            for (int ply = 0; ply <= options.maxPlies; ply++)
+            {
+                SearchResult cached;
+                if (seen.insert(pos.key()).second)
+                {
+                    // mate and stalemate have no bestmove to store, so they would be searched every run
+                    MoveList legal;
+                    pos.legalMoves(legal);
+                    if (legal.size == 0)
+                        terminal++;
+                    else if (cache.probe(pos.key(), cached) && cached.depth >= options.depth)
+                        skipped++;
+                    else
+                        pending.push_back(pos.fen());
+                }
+
+                if (ply == int(sanMoves.size()))
+                    break;
+                Move m = parseSan(pos, sanMoves[ply]);
+                if (m == NoMove)
+                {
+                    std::cerr << "Game " << games << ": cannot parse move " << sanMoves[ply] << "\n";
+                    break;
+                }
+                pos.doMove(m);
+            }
+            std::reverse(pending.begin(), pending.end());
+        }
+
+        fen = std::move(pending.back());
+        pending.pop_back();
+        return true;
+    };
+
+    std::atomic<std::size_t> failures{0};
+    analyseAll(options, nextPosition, [&](const BatchJob& job, const SearchResult* r, const std::string&)
+    {
+        Position pos;
+        if (r && pos.setFen(job.fen))
+            cache.store(pos.key(), *r);
+        else
+            failures++;
+    });
+
+    std::cerr << games << " games, " << seen.size() << " unique positions, " << skipped
+              << " already cached, " << terminal << " mate/stalemate, " << failures << " failed\n";
+    return 0;
+}
@@ -0,0 +1,60 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Headless analysis of EPD/FEN files and PGN corpora over a pool of engines
+*/
+
+#pragma once
+
+#include "analysis.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+struct BatchOptions
+{
+    std::string inputPath;
+    std::string outputPath;     // empty writes to stdout
+    std::string enginePath = "../src/stockfish";
+    std::size_t engines = 0;    // 0 picks one per core
+    int depth = 12;
+    int hashMB = 0;             // per engine; 0 sizes it from free memory
+
+    std::string cachePath = "analysis.cache";   // empty disables the cache
+    std::size_t cacheSizeMB = 64;
+    int maxPlies = 40;          // how deep into each PGN game to prebuild
+};
+
+// One position handed to the engine pool
+struct BatchJob
+{
+    std::size_t index = 0;
+    std::string fen;
+};
+
+// Called for every finished job, usually on a worker thread; result is null when the engine
+// failed or the FEN was invalid (then on the reading thread, before the job is queued)
+using BatchResultHandler = std::function<void(const BatchJob& job, const SearchResult* result, const std::string& error)>;
+
+// Searches every position the source yields across a pool of engines
+// Input: options, source called on this thread until it returns false, result handler
+// Output: number of positions analysed
+std::size_t analyseAll(const BatchOptions& options, const std::function<bool(std::string& fen)>& source,
+                       const BatchResultHandler& onResult);
+
+// Analyses every position in the input file and writes results in input order
+// Input: BatchOptions
+// Output: process exit code (1 if the files cannot be opened, 2 if any position failed)
+int runBatch(const BatchOptions& options);
+
+// Replays every game of a PGN corpus and stores engine analysis in the cache
+// Input: BatchOptions (inputPath is the PGN file)
+// Output: process exit code
+int runCacheBuild(const BatchOptions& options);
+
+// Converts an EPD or FEN record to a full six-field FEN
+// Input: one line of the input file
+// Output: FEN string, empty for blank or comment lines
+std::string epdToFen(const std::string& line);
@@ -0,0 +1,457 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: chess_bench - reproducible latency and throughput numbers for the hot paths of the game
+*/
+
+#include "bench_report.h"
+#include "analysis.h"
+#include "embedded_engine.h"
+#include "engine_transport.h"
+#include "game.h"
+#include "pgn.h"
+#include "renderer.h"
+#include "uci_engine.h"
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Used when no --pgn is given, so runs are comparable across machines and checkouts
+    const char* const BuiltinGames = R"(
+[Event "Paris"]
+[White "Paul Morphy"]
+[Black "Duke Karl / Count Isouard"]
+[Result "1-0"]
+
+1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7
+8. Nc3 c6 9. Bg5 b5 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7
+14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+ Nxb8 17. Rd8# 1-0
+
+[Event "London"]
+[White "Adolf Anderssen"]
+[Black "Lionel Kieseritzky"]
+[Result "1-0"]
+
+1. e4 e5 2. f4 exf4 3. Bc4 Qh4+ 4. Kf1 b5 5. Bxb5 Nf6 6. Nf3 Qh6 7. d3 Nh5
+8. Nh4 Qg5 9. Nf5 c6 10. g4 Nf6 11. Rg1 cxb5 12. h4 Qg6 13. h5 Qg5 14. Qf3 Ng8
+15. Bxf4 Qf6 16. Nc3 Bc5 17. Nd5 Qxb2 18. Bd6 Bxg1 19. e5 Qxa1+ 20. Ke2 Na6
+21. Nxg7+ Kd8 22. Qf6+ Nxf6 23. Be7# 1-0
+)";
+
+    // Output of one Stockfish search, replayed by the parse benchmarks
+    const char* const SearchTranscript =
+        "info string NNUE evaluation using nn-b1a57edbea57.nnue enabled\n"
+        "info depth 1 seldepth 1 multipv 1 score cp 18 nodes 20 nps 20000 hashfull 0 tbhits 0 time 1 pv e2e4\n"
+        "info depth 2 seldepth 2 multipv 1 score cp 46 nodes 66 nps 66000 hashfull 0 tbhits 0 time 1 pv d2d4 d7d5\n"
+        "info depth 3 seldepth 2 multipv 1 score cp 51 nodes 120 nps 120000 hashfull 0 tbhits 0 time 1 pv e2e4 e7e5\n"
+        "info depth 4 seldepth 3 multipv 1 score cp 58 nodes 251 nps 251000 hashfull 0 tbhits 0 time 1 pv e2e4 e7e5 g1f3\n"
+        "info depth 5 seldepth 4 multipv 1 score cp 58 nodes 492 nps 492000 hashfull 0 tbhits 0 time 1 pv e2e4 e7e5 g1f3 b8c6\n"
+        "info depth 6 seldepth 5 multipv 1 score cp 43 nodes 1246 nps 623000 hashfull 0 tbhits 0 time 2 pv e2e4 e7e5 g1f3 b8c6 f1b5\n"
+        "info depth 7 seldepth 7 multipv 1 score cp 39 nodes 2818 nps 704500 hashfull 1 tbhits 0 time 4 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1\n"
+        "info depth 8 seldepth 8 multipv 1 score cp 35 nodes 6072 nps 759000 hashfull 2 tbhits 0 time 8 pv e2e4 e7e5 g1f3 b8c6 f1b5 g8f6 e1g1 f6e4\n"
+        "info depth 9 seldepth 11 multipv 1 score cp 33 nodes 11904 nps 793600 hashfull 4 tbhits 0 time 15 pv e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6 e1g1\n"
+        "info depth 10 seldepth 13 multipv 1 score cp 35 nodes 22715 nps 811250 hashfull 8 tbhits 0 time 28 pv e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6 e1g1 f8e7\n"
+        "info depth 11 currmove e2e4 currmovenumber 1\n"
+        "info depth 11 currmove d2d4 currmovenumber 2\n"
+        "info depth 11 seldepth 15 multipv 1 score cp 31 lowerbound nodes 41102 nps 822040 hashfull 14 tbhits 0 time 50 pv e2e4\n"
+        "info depth 11 seldepth 15 multipv 1 score cp 29 nodes 48830 nps 830000 hashfull 16 tbhits 0 time 59 pv e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6 e1g1 f8e7 f1e1\n"
+        "info depth 12 seldepth 17 multipv 1 score cp 30 nodes 90571 nps 847000 hashfull 29 tbhits 0 time 107 pv e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6 e1g1 f8e7 f1e1 b7b5 a4b3\n"
+        "bestmove e2e4 ponder e7e5\n";
+
+    struct BenchOptions
+    {
+        std::string backend = EmbeddedTransport::available() ? "embedded" : "pipe";
+        std::string enginePath = "../src/stockfish";
+        std::vector<int> depths{1, 4, 8, 12};
+        std::string pgnPath;
+        std::string fontPath = "../src/chess.ttf";
+        std::string outPath;
+        std::string baselinePath;
+        double threshold = 0.10;
+    };
+
+    double elapsedNs(Clock::time_point start)
+    {
+        return double(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    // Serves the same bytes over and over, in pipe-sized chunks
+    class ReplayTransport : public EngineTransport
+    {
+    public:
+        explicit ReplayTransport(std::string text) : text(std::move(text)) {}
+
+        void write(const char*, std::size_t) override {}
+
+        std::size_t read(char* out, std::size_t cap, Clock::time_point) override
+        {
+            std::size_t n = std::min({cap, text.size() - at, std::size_t(4096)});
+            std::copy_n(text.data() + at, n, out);
+            at = (at + n) % text.size();
+            return n;
+        }
+
+        void close() override {}
+
+    private:
+        std::string text;
+        std::size_t at = 0;
+    };
+
+    // Converts every game in the PGN text to UCI moves
+    // Input: PGN stream
+    // Output: one move list per game (games that fail to parse are cut short)
+    std::vector<std::vector<std::string>> loadGames(std::istream& in)
+    {
+        std::vector<std::vector<std::string>> games;
+        PgnReader reader(in);
+        std::string startFen;
+        std::vector<std::string> sanMoves;
+        while (reader.nextGame(startFen, sanMoves))
+        {
+            // the benchmarks replay from the start position through Game
+            if (startFen != Position::StartFen)
+                continue;
+
+            Position pos;
+            std::vector<std::string> moves;
+            for (const std::string& san : sanMoves)
+            {
+                Move m = parseSan(pos, san);
+                if (m == NoMove)
+                    break;
+                moves.push_back(Position::toUci(m));
+                pos.doMove(m);
+            }
+            games.push_back(moves);
+        }
+        return games;
+    }
+
+    // getLegalMoves plus the membership check the game loop does for every user move
+    // Input: recorded games, report
+    // Output: None
+    void benchMoveGen(const std::vector<std::vector<std::string>>& games, BenchReport& report)
+    {
+        const int Rounds = 200;
+        std::vector<double> samples;
+        std::size_t found = 0;
+        for (int round = 0; round < Rounds; round++)
+        {
+            for (const auto& moves : games)
+            {
+                Game game;
+                for (const std::string& move : moves)
+                {
+                    auto start = Clock::now();
+                    auto legal = getLegalMoves(game.position());
+                    found += std::find(legal.begin(), legal.end(), move) != legal.end();
+                    double ns = elapsedNs(start);
+                    if (round > 0)
+                        samples.push_back(ns);
+                    game.play(move);
+                }
+            }
+        }
+        std::cerr << "movegen: " << samples.size() << " plies timed, " << found << " moves found legal\n";
+        report.add("movegen.validate_ply", "ns", samples);
+    }
+
+    // Engine output parsing on its own and through UciEngine's line framing
+    // Input: report
+    // Output: None
+    void benchParse(BenchReport& report)
+    {
+        const int Searches = 20000;
+        std::vector<std::string_view> lines;
+        std::string_view rest(SearchTranscript);
+        while (!rest.empty())
+        {
+            std::size_t nl = rest.find('\n');
+            lines.push_back(rest.substr(0, nl));
+            rest.remove_prefix(nl + 1);
+        }
+
+        std::vector<double> direct;
+        std::uint64_t depthSum = 0;
+        for (int i = 0; i < Searches; i++)
+        {
+            auto start = Clock::now();
+            SearchResult result;
+            for (std::string_view line : lines)
+            {
+                if (!parseBestMoveLine(line, result))
+                    parseInfoLine(line, result);
+            }
+            direct.push_back(elapsedNs(start) / lines.size());
+            depthSum += result.depth;
+        }
+        report.add("parse.info_line", "ns", direct);
+
+        UciEngine replay;
+        replay.start(std::make_unique<ReplayTransport>(SearchTranscript));
+        std::vector<double> framed;
+        for (int i = 0; i < Searches; i++)
+        {
+            auto start = Clock::now();
+            SearchResult result;
+            replay.readLines(std::chrono::seconds(1), [&](std::string_view line)
+            {
+                if (parseBestMoveLine(line, result))
+                    return true;
+                parseInfoLine(line, result);
+                return false;
+            });
+            framed.push_back(elapsedNs(start) / lines.size());
+            depthSum += result.depth;
+        }
+        report.add("parse.framed_line", "ns", framed);
+
+        std::vector<double> until;
+        for (int i = 0; i < Searches; i++)
+        {
+            auto start = Clock::now();
+            depthSum += replay.readUntil("bestmove", std::chrono::seconds(1)).size();
+            until.push_back(elapsedNs(start) / lines.size());
+        }
+        report.add("parse.read_until_line", "ns", until);
+        std::cerr << "parse: " << Searches << " transcripts x " << lines.size() << " lines (" << depthSum << ")\n";
+    }
+
+    // Starts the engine and runs the same handshake as the game
+    // Input: options, engine
+    // Output: None (throws UciError)
+    void startEngine(const BenchOptions& options, UciEngine& engine)
+    {
+        const std::chrono::milliseconds Timeout(10000);
+        if (options.backend == "embedded")
+            engine.start(std::make_unique<EmbeddedTransport>());
+        else
+            engine.start(options.enginePath);
+        engine.send("uci");
+        engine.readUntil("uciok", Timeout);
+        engine.send("isready");
+        engine.readUntil("readyok", Timeout);
+    }
+
+    // UCI round trips: start-up handshake, isready, and position+go at several depths
+    // Input: options, positions as "position ..." commands, report
+    // Output: None
+    void benchEngine(const BenchOptions& options, const std::vector<std::string>& positions, BenchReport& report)
+    {
+        const std::string prefix = "uci." + options.backend + ".";
+        if (options.backend == "none")
+            return;
+
+        try
+        {
+            UciEngine engine;
+            std::vector<double> handshake;
+            for (int i = 0; i < 5; i++)
+            {
+                auto start = Clock::now();
+                startEngine(options, engine);
+                handshake.push_back(elapsedNs(start) / 1e6);
+                engine.stop();
+            }
+            report.add(prefix + "handshake", "ms", handshake);
+
+            startEngine(options, engine);
+            engine.send("setoption name Threads value 1");
+            engine.send("setoption name Hash value 16");
+
+            std::vector<double> ready;
+            for (int i = 0; i < 2100; i++)
+            {
+                auto start = Clock::now();
+                engine.send("isready");
+                engine.readUntil("readyok", std::chrono::seconds(5));
+                if (i >= 100)
+                    ready.push_back(elapsedNs(start) / 1e3);
+            }
+            report.add(prefix + "isready", "us", ready);
+
+            for (int depth : options.depths)
+            {
+                std::vector<double> search;
+                for (const std::string& position : positions)
+                {
+                    // a fresh hash table keeps each sample independent of the previous one
+                    engine.send("ucinewgame");
+                    engine.send("isready");
+                    engine.readUntil("readyok", std::chrono::seconds(5));
+
+                    auto start = Clock::now();
+                    runSearch(engine, position, "go depth " + std::to_string(depth), std::chrono::seconds(120));
+                    search.push_back(elapsedNs(start) / 1e6);
+                }
+                report.add(prefix + "go_depth_" + std::to_string(depth), "ms", search);
+                std::cerr << "engine: depth " << depth << " over " << positions.size() << " positions\n";
+            }
+        }
+        catch (const UciError& e)
+        {
+            std::cerr << "engine: skipped (" << e.what() << ")\n";
+            report.skip(prefix + "*", e.what());
+        }
+    }
+
+    // Offscreen version of displayBoard: rebuild the pieces and draw into a RenderTexture.
+    // Like the windowed path this times command submission, not GPU completion.
+    // Input: options, positions to cycle through, report
+    // Output: None
+    void benchRender(const BenchOptions& options, const std::vector<Position>& positions, BenchReport& report)
+    {
+        const float TileSize = 80.f;
+        sf::Font font;
+        if (!font.loadFromFile(options.fontPath))
+        {
+            report.skip("render.frame", "cannot load font " + options.fontPath);
+            return;
+        }
+        sf::RenderTexture target;
+        if (!target.create(unsigned(8 * TileSize), unsigned(8 * TileSize)))
+        {
+            report.skip("render.frame", "cannot create a RenderTexture (no GL context)");
+            return;
+        }
+
+        BoardRenderer renderer(TileSize, font);
+        std::vector<double> frames;
+        for (std::size_t i = 0; i < 1100; i++)
+        {
+            auto start = Clock::now();
+            renderer.setPosition(positions[i % positions.size()]);
+            renderer.draw(target);
+            target.display();
+            if (i >= 100)
+                frames.push_back(elapsedNs(start) / 1e3);
+        }
+        report.add("render.frame", "us", frames);
+        std::cerr << "render: " << frames.size() << " frames\n";
+    }
+
+    // Input: comma separated integers like "1,4,8"
+    // Output: the integers
+    std::vector<int> parseDepths(const std::string& text)
+    {
+        std::vector<int> depths;
+        std::stringstream in(text);
+        std::string item;
+        while (std::getline(in, item, ','))
+            depths.push_back(std::stoi(item));
+        return depths;
+    }
+}
+
+// chess_bench [--pgn games.pgn] [--engine embedded|pipe|none] [--engine-path p] [--depths 1,4,8]
+//             [--font f] [--out results.json] [--baseline old.json] [--threshold 0.1]
+// Exit status: 0 ok, 1 bad usage or unreadable baseline, 2 a benchmark regressed against the baseline
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try
+        {
+            if (arg == "--pgn" && hasValue) options.pgnPath = argv[++i];
+            else if (arg == "--engine" && hasValue) options.backend = argv[++i];
+            else if (arg == "--engine-path" && hasValue) options.enginePath = argv[++i];
+            else if (arg == "--depths" && hasValue) options.depths = parseDepths(argv[++i]);
+            else if (arg == "--font" && hasValue) options.fontPath = argv[++i];
+            else if (arg == "--out" && hasValue) options.outPath = argv[++i];
+            else if (arg == "--baseline" && hasValue) options.baselinePath = argv[++i];
+            else if (arg == "--threshold" && hasValue) options.threshold = std::stod(argv[++i]);
+            else
+            {
+                std::cerr << "Unknown argument: " << arg << "\n";
+                return 1;
+            }
+        }
+        catch (const std::logic_error&)
+        {
+            // std::stoi and friends throw invalid_argument or out_of_range
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<std::vector<std::string>> games;
+    if (options.pgnPath.empty())
+    {
+        std::istringstream in(BuiltinGames);
+        games = loadGames(in);
+    }
+    else
+    {
+        std::ifstream in(options.pgnPath);
+        if (!in)
+        {
+            std::cerr << "Cannot open " << options.pgnPath << "\n";
+            return 1;
+        }
+        games = loadGames(in);
+    }
+    if (games.empty())
+    {
+        std::cerr << "No games to replay\n";
+        return 1;
+    }
+
+    // every position of every game for rendering, every sixth one (at most 16) for the engine
+    std::vector<Position> boards;
+    std::vector<std::string> searchPositions;
+    for (const auto& moves : games)
+    {
+        Game game;
+        for (std::size_t ply = 0; ply < moves.size(); ply++)
+        {
+            boards.push_back(game.position());
+            if (ply % 6 == 0 && searchPositions.size() < 16)
+                searchPositions.push_back(game.uciPosition());
+            game.play(moves[ply]);
+        }
+    }
+
+    BenchReport report;
+    benchMoveGen(games, report);
+    benchParse(report);
+    benchEngine(options, searchPositions, report);
+    benchRender(options, boards, report);
+
+    if (options.outPath.empty())
+        report.writeJson(std::cout);
+    else
+    {
+        std::ofstream out(options.outPath);
+        report.writeJson(out);
+    }
+
+    if (options.baselinePath.empty())
+        return 0;
+    int regressions = report.compare(options.baselinePath, options.threshold, std::cerr);
+    if (regressions < 0)
+    {
+        std::cerr << "Cannot read baseline " << options.baselinePath << "\n";
+        return 1;
+    }
+    std::cerr << regressions << " regression(s) beyond " << options.threshold * 100 << "%\n";
+    return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,162 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Percentile summaries for chess_bench, JSON output and baseline comparison
+*/
+
+#include "bench_report.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <numeric>
+#include <utility>
+
+namespace
+{
+    // Nearest-rank percentile of sorted samples
+    // Input: sorted samples, fraction in [0, 1]
+    // Output: sample value
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        return sorted[std::size_t(p * (sorted.size() - 1) + 0.5)];
+    }
+
+    // Escapes the few characters that can appear in names and skip reasons
+    std::string quoted(const std::string& s)
+    {
+        std::string out = "\"";
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    // Pulls a number out of a line written by writeJson
+    // Input: line, field name
+    // Output: value, or -1 if the field is missing
+    double field(const std::string& line, const std::string& key)
+    {
+        std::size_t at = line.find("\"" + key + "\": ");
+        if (at == std::string::npos)
+            return -1;
+        return std::strtod(line.c_str() + at + key.size() + 4, nullptr);
+    }
+}
+
+// Summarizes raw samples under a name
+// Input: name like "movegen.ply", unit like "ns", samples (reordered)
+// Output: None
+void BenchReport::add(const std::string& name, const std::string& unit, std::vector<double>& samples)
+{
+    if (samples.empty())
+    {
+        skip(name, "no samples");
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    BenchSummary s;
+    s.name = name;
+    s.unit = unit;
+    s.count = samples.size();
+    s.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    s.min = samples.front();
+    s.p50 = percentile(samples, 0.50);
+    s.p90 = percentile(samples, 0.90);
+    s.p99 = percentile(samples, 0.99);
+    s.max = samples.back();
+    results.push_back(s);
+}
+
+// Records why a benchmark could not run, e.g. no engine or no GL context
+// Input: name, reason
+// Output: None
+void BenchReport::skip(const std::string& name, const std::string& reason)
+{
+    skipped.emplace_back(name, reason);
+}
+
+// Writes all results as JSON, one benchmark per line so the file diffs well
+// Input: stream
+// Output: None
+void BenchReport::writeJson(std::ostream& out) const
+{
+    out << std::setprecision(6);
+    out << "{\n  \"schema\": 1,\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const BenchSummary& s = results[i];
+        out << "    {\"name\": " << quoted(s.name) << ", \"unit\": " << quoted(s.unit)
+            << ", \"count\": " << s.count << ", \"mean\": " << s.mean << ", \"min\": " << s.min
+            << ", \"p50\": " << s.p50 << ", \"p90\": " << s.p90 << ", \"p99\": " << s.p99
+            << ", \"max\": " << s.max << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n  \"skipped\": [\n";
+    for (std::size_t i = 0; i < skipped.size(); i++)
+    {
+        out << "    {\"name\": " << quoted(skipped[i].first) << ", \"reason\": " << quoted(skipped[i].second)
+            << "}" << (i + 1 < skipped.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Compares p50 against a report saved earlier by writeJson
+// Input: baseline path, allowed slowdown (0.1 = 10%), stream for the comparison table
+// Output: number of regressions, or -1 if the baseline cannot be read
+int BenchReport::compare(const std::string& baselinePath, double threshold, std::ostream& log) const
+{
+    std::ifstream in(baselinePath);
+    if (!in)
+        return -1;
+
+    // the baseline is our own output, so a line-oriented read is enough
+    std::map<std::string, std::pair<double, double>> baseline;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        const std::string tag = "{\"name\": \"";
+        std::size_t at = line.find(tag);
+        if (at == std::string::npos || line.find("\"p50\"") == std::string::npos)
+            continue;
+        std::size_t end = line.find('"', at + tag.size());
+        baseline[line.substr(at + tag.size(), end - at - tag.size())] = {field(line, "p50"), field(line, "p90")};
+    }
+
+    int regressions = 0;
+    log << std::fixed << std::setprecision(3);
+    log << std::left << std::setw(28) << "benchmark" << std::right << std::setw(14) << "base p50"
+        << std::setw(14) << "now p50" << std::setw(9) << "ratio" << std::setw(9) << "p90" << "\n";
+    for (const BenchSummary& s : results)
+    {
+        auto it = baseline.find(s.name);
+        if (it == baseline.end() || it->second.first <= 0)
+        {
+            log << std::left << std::setw(28) << s.name << std::right << std::setw(14) << "-"
+                << std::setw(14) << s.p50 << "   (new)\n";
+            continue;
+        }
+
+        double ratio = s.p50 / it->second.first;
+        double ratio90 = it->second.second > 0 ? s.p90 / it->second.second : 0;
+        bool slower = ratio > 1 + threshold;
+        regressions += slower;
+        log << std::left << std::setw(28) << s.name << std::right << std::setw(14) << it->second.first
+            << std::setw(14) << s.p50 << std::setw(9) << ratio << std::setw(9) << ratio90
+            << (slower ? "   REGRESSION" : "") << "\n";
+    }
+    for (const auto& b : baseline)
+    {
+        bool present = std::any_of(results.begin(), results.end(),
+                                   [&](const BenchSummary& s) { return s.name == b.first; });
+        if (!present)
+            log << std::left << std::setw(28) << b.first << "   (not run)\n";
+    }
+    return regressions;
+}
@@ -0,0 +1,56 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Percentile summaries for chess_bench, JSON output and baseline comparison
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Distribution of one benchmark's samples; every metric is "lower is better"
+struct BenchSummary
+{
+    std::string name;
+    std::string unit;
+    std::size_t count = 0;
+    double mean = 0;
+    double min = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+// Collects benchmark results and writes them in a format chess_bench can read back
+class BenchReport
+{
+public:
+    // Summarizes raw samples under a name
+    // Input: name like "movegen.ply", unit like "ns", samples (reordered)
+    // Output: None
+    void add(const std::string& name, const std::string& unit, std::vector<double>& samples);
+
+    // Records why a benchmark could not run, e.g. no engine or no GL context
+    // Input: name, reason
+    // Output: None
+    void skip(const std::string& name, const std::string& reason);
+
+    // Writes all results as JSON, one benchmark per line so the file diffs well
+    // Input: stream
+    // Output: None
+    void writeJson(std::ostream& out) const;
+
+    // Compares p50 against a report saved earlier by writeJson
+    // Input: baseline path, allowed slowdown (0.1 = 10%), stream for the comparison table
+    // Output: number of regressions, or -1 if the baseline cannot be read
+    int compare(const std::string& baselinePath, double threshold, std::ostream& log) const;
+
+private:
+    std::vector<BenchSummary> results;
+    std::vector<std::pair<std::string, std::string>> skipped;
+};
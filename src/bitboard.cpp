@@ -0,0 +1,113 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Bitboard types, compile-time attack tables and magic sliding attacks
+*/
+
+#include "bitboard.h"
+
+Magic RookMagics[64];
+Magic BishopMagics[64];
+
+namespace
+{
+    Bitboard RookTable[0x19000];
+    Bitboard BishopTable[0x1480];
+
+    // xorshift64* generator, seeded per rank so the search is deterministic
+    class Prng
+    {
+    public:
+        explicit Prng(std::uint64_t seed) : s(seed) {}
+
+        std::uint64_t rand()
+        {
+            s ^= s >> 12;
+            s ^= s << 25;
+            s ^= s >> 27;
+            return s * 2685821657736338717ULL;
+        }
+
+        // Magics work best with few bits set
+        std::uint64_t sparseRand() { return rand() & rand() & rand(); }
+
+    private:
+        std::uint64_t s;
+    };
+
+    // Builds the attack table for one slider type using fancy magics
+    // Input: table storage, magics to fill, rook or bishop
+    // Output: None
+    void initMagics(Bitboard table[], Magic magics[], bool rook)
+    {
+        Bitboard reference[4096];
+#ifndef USE_PEXT
+        Bitboard occupancy[4096];
+        const std::uint64_t seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+        int epoch[4096] = {};
+        int cnt = 0;
+#endif
+
+        for (Square s = 0; s < 64; s++)
+        {
+            // edges never block the slider, so leave them out of the mask
+            Bitboard edges = ((Rank1BB | Rank8BB) & ~(Rank1BB << (8 * rankOf(s))))
+                           | ((FileABB | FileHBB) & ~(FileABB << fileOf(s)));
+
+            Magic& m = magics[s];
+            m.mask = detail::slidingAttacks(s, 0, rook) & ~edges;
+            m.shift = 64 - popcount(m.mask);
+            m.attacks = s == 0 ? table : magics[s - 1].attacks + (std::size_t(1) << (64 - magics[s - 1].shift));
+
+            // enumerate every subset of the mask (Carry-Rippler)
+            int size = 0;
+            Bitboard b = 0;
+            do
+            {
+                reference[size] = detail::slidingAttacks(s, b, rook);
+#ifdef USE_PEXT
+                m.attacks[m.index(b)] = reference[size];
+#else
+                occupancy[size] = b;
+#endif
+                size++;
+                b = (b - m.mask) & m.mask;
+            } while (b);
+
+#ifndef USE_PEXT
+            // try random magics until every occupancy maps to a consistent entry
+            Prng rng(seeds[rankOf(s)]);
+            for (int i = 0; i < size;)
+            {
+                for (m.magic = 0; popcount((m.magic * m.mask) >> 56) < 6;)
+                    m.magic = rng.sparseRand();
+
+                for (++cnt, i = 0; i < size; i++)
+                {
+                    unsigned idx = m.index(occupancy[i]);
+                    if (epoch[idx] < cnt)
+                    {
+                        epoch[idx] = cnt;
+                        m.attacks[idx] = reference[i];
+                    }
+                    else if (m.attacks[idx] != reference[i])
+                        break;
+                }
+            }
+#endif
+        }
+    }
+
+    struct MagicInit
+    {
+        MagicInit()
+        {
+            initMagics(RookTable, RookMagics, true);
+            initMagics(BishopTable, BishopMagics, false);
+        }
+    };
+
+    // Runs before main so the lookup functions never see empty tables
+    const MagicInit magicInit;
+}
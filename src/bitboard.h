@@ -0,0 +1,196 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Bitboard types, compile-time attack tables and magic sliding attacks
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#define USE_PEXT
+#endif
+
+using Bitboard = std::uint64_t;
+
+// Squares run a1 = 0, b1 = 1, ... h8 = 63
+using Square = int;
+constexpr Square NoSquare = 64;
+
+enum Color { White, Black };
+
+enum PieceType { NoPieceType, Pawn, Knight, Bishop, Rook, Queen, King };
+
+// Piece codes are (color << 3) | type, with 0 for an empty square
+using Piece = std::uint8_t;
+constexpr Piece NoPiece = 0;
+
+constexpr Piece makePiece(Color c, PieceType pt) { return Piece((c << 3) | pt); }
+constexpr PieceType typeOf(Piece p) { return PieceType(p & 7); }
+constexpr Color colorOf(Piece p) { return Color(p >> 3); }
+
+constexpr int fileOf(Square s) { return s & 7; }
+constexpr int rankOf(Square s) { return s >> 3; }
+constexpr Square makeSquare(int file, int rank) { return rank * 8 + file; }
+constexpr Bitboard squareBB(Square s) { return Bitboard(1) << s; }
+
+constexpr Bitboard FileABB = 0x0101010101010101ULL;
+constexpr Bitboard FileHBB = FileABB << 7;
+constexpr Bitboard Rank1BB = 0xFFULL;
+constexpr Bitboard Rank8BB = Rank1BB << 56;
+
+inline int popcount(Bitboard b) { return __builtin_popcountll(b); }
+inline Square lsb(Bitboard b) { return __builtin_ctzll(b); }
+
+// Removes and returns the lowest set square
+inline Square popLsb(Bitboard& b)
+{
+    Square s = lsb(b);
+    b &= b - 1;
+    return s;
+}
+
+namespace detail
+{
+    // Adds the square at (file + df, rank + dr) if it is on the board
+    constexpr Bitboard offsetBB(Square s, int df, int dr)
+    {
+        int f = fileOf(s) + df;
+        int r = rankOf(s) + dr;
+        return (f >= 0 && f < 8 && r >= 0 && r < 8) ? squareBB(makeSquare(f, r)) : 0;
+    }
+
+    // Walks each direction until blocked, including the blocker
+    constexpr Bitboard slidingAttacks(Square s, Bitboard occupied, bool rook)
+    {
+        constexpr int rookDirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        constexpr int bishopDirs[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+        Bitboard attacks = 0;
+        for (int d = 0; d < 4; d++)
+        {
+            int df = rook ? rookDirs[d][0] : bishopDirs[d][0];
+            int dr = rook ? rookDirs[d][1] : bishopDirs[d][1];
+            int f = fileOf(s) + df;
+            int r = rankOf(s) + dr;
+            while (f >= 0 && f < 8 && r >= 0 && r < 8)
+            {
+                Bitboard b = squareBB(makeSquare(f, r));
+                attacks |= b;
+                if (occupied & b)
+                    break;
+                f += df;
+                r += dr;
+            }
+        }
+        return attacks;
+    }
+
+    constexpr std::array<Bitboard, 64> makeKnightTable()
+    {
+        std::array<Bitboard, 64> t{};
+        for (Square s = 0; s < 64; s++)
+            t[s] = offsetBB(s, 1, 2) | offsetBB(s, 2, 1) | offsetBB(s, 2, -1) | offsetBB(s, 1, -2)
+                 | offsetBB(s, -1, -2) | offsetBB(s, -2, -1) | offsetBB(s, -2, 1) | offsetBB(s, -1, 2);
+        return t;
+    }
+
+    constexpr std::array<Bitboard, 64> makeKingTable()
+    {
+        std::array<Bitboard, 64> t{};
+        for (Square s = 0; s < 64; s++)
+            for (int df = -1; df <= 1; df++)
+                for (int dr = -1; dr <= 1; dr++)
+                    if (df || dr)
+                        t[s] |= offsetBB(s, df, dr);
+        return t;
+    }
+
+    constexpr std::array<std::array<Bitboard, 64>, 2> makePawnTable()
+    {
+        std::array<std::array<Bitboard, 64>, 2> t{};
+        for (Square s = 0; s < 64; s++)
+        {
+            t[White][s] = offsetBB(s, -1, 1) | offsetBB(s, 1, 1);
+            t[Black][s] = offsetBB(s, -1, -1) | offsetBB(s, 1, -1);
+        }
+        return t;
+    }
+
+    // between[a][b]: squares strictly between two aligned squares
+    // line[a][b]: the whole rank, file or diagonal through both (0 if not aligned)
+    struct LineTables
+    {
+        std::array<std::array<Bitboard, 64>, 64> between{};
+        std::array<std::array<Bitboard, 64>, 64> line{};
+    };
+
+    constexpr LineTables makeLineTables()
+    {
+        LineTables t{};
+        for (Square a = 0; a < 64; a++)
+            for (int rook = 0; rook < 2; rook++)
+            {
+                Bitboard rays = slidingAttacks(a, 0, rook);
+                for (Square b = 0; b < 64; b++)
+                {
+                    if (!(rays & squareBB(b)))
+                        continue;
+                    t.between[a][b] = slidingAttacks(a, squareBB(b), rook) & slidingAttacks(b, squareBB(a), rook);
+                    t.line[a][b] = (rays & slidingAttacks(b, 0, rook)) | squareBB(a) | squareBB(b);
+                }
+            }
+        return t;
+    }
+}
+
+constexpr std::array<Bitboard, 64> KnightAttacks = detail::makeKnightTable();
+constexpr std::array<Bitboard, 64> KingAttacks = detail::makeKingTable();
+constexpr std::array<std::array<Bitboard, 64>, 2> PawnAttacks = detail::makePawnTable();
+constexpr detail::LineTables Lines = detail::makeLineTables();
+
+inline Bitboard betweenBB(Square a, Square b) { return Lines.between[a][b]; }
+inline Bitboard lineBB(Square a, Square b) { return Lines.line[a][b]; }
+
+// Magic (or PEXT) lookup into the shared slider attack tables
+struct Magic
+{
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned shift;
+
+    unsigned index(Bitboard occupied) const
+    {
+#ifdef USE_PEXT
+        return unsigned(_pext_u64(occupied, mask));
+#else
+        return unsigned(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+// Filled once at startup; searching magics is too slow for constexpr evaluation
+extern Magic RookMagics[64];
+extern Magic BishopMagics[64];
+
+inline Bitboard rookAttacks(Square s, Bitboard occupied)
+{
+    const Magic& m = RookMagics[s];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard bishopAttacks(Square s, Bitboard occupied)
+{
+    const Magic& m = BishopMagics[s];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(Square s, Bitboard occupied)
+{
+    return rookAttacks(s, occupied) | bishopAttacks(s, occupied);
+}
@@ -0,0 +1,29 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Terminal streams for the app that survive the embedded engine taking over std::cin/std::cout
+*/
+
+#include "console.h"
+
+#include <iostream>
+
+// Stream to the terminal; use instead of std::cout for anything the player should see
+// Input: None
+// Output: stream bound to the original stdout buffer
+std::ostream& console()
+{
+    // captured on first use, which the embedded engine guarantees happens before it swaps buffers
+    static std::ostream out(std::cout.rdbuf());
+    return out;
+}
+
+// Stream from the terminal; use instead of std::cin for player input
+// Input: None
+// Output: stream bound to the original stdin buffer
+std::istream& consoleInput()
+{
+    static std::istream in(std::cin.rdbuf());
+    return in;
+}
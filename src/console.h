@@ -0,0 +1,21 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Terminal streams for the app that survive the embedded engine taking over std::cin/std::cout
+*/
+
+#pragma once
+
+#include <istream>
+#include <ostream>
+
+// Stream to the terminal; use instead of std::cout for anything the player should see
+// Input: None
+// Output: stream bound to the original stdout buffer
+std::ostream& console();
+
+// Stream from the terminal; use instead of std::cin for player input
+// Input: None
+// Output: stream bound to the original stdin buffer
+std::istream& consoleInput();
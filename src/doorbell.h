@@ -0,0 +1,55 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Lets the consumer of a lock-free queue block until its producer publishes
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// The producer pays one atomic load per publish unless the consumer is actually asleep.
+// Any number of producers may ring one bell.
+class Doorbell
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Consumer: sleeps until ready() holds or the deadline passes. ready() is re-checked
+    // after announcing the sleep, so a ring just before the wait is never lost.
+    // Input: deadline (time_point::max() waits for ever), predicate on the queue state
+    // Output: None
+    template <typename Ready>
+    void wait(Clock::time_point deadline, Ready ready)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        sleepers.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (deadline == Clock::time_point::max())
+            cv.wait(lock, ready);
+        else
+            cv.wait_until(lock, deadline, ready);
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Producer: wakes the consumer if it is asleep; call after publishing
+    void ring()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) == 0)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        cv.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<int> sleepers{0};
+};
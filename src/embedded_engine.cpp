@@ -0,0 +1,289 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Stockfish linked into the app and driven over in-memory lock-free channels
+*/
+
+#include "embedded_engine.h"
+#include "console.h"
+#include "doorbell.h"
+#include "spsc_queue.h"
+#include "uci_engine.h"
+
+#include <array>
+#include <atomic>
+#include <iostream>
+
+#ifdef CHESS_EMBED_STOCKFISH
+// Stockfish's own main(), renamed when its sources are built as a library (see src/CMakeLists.txt)
+int stockfish_embedded_main(int argc, char* argv[]);
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // set while an embedded engine owns std::cin/std::cout
+    std::atomic<bool> active{false};
+
+    // Replies to most commands arrive within microseconds, so a waiter spins, then yields,
+    // before it blocks
+    // Input: counter owned by the waiting loop
+    // Output: false once the caller should block instead
+    bool spinBriefly(int& spins)
+    {
+        if (spins < 64)
+        {
+            spins++;
+            return true;
+        }
+        if (spins < 128)
+        {
+            spins++;
+            std::this_thread::yield();
+            return true;
+        }
+        return false;
+    }
+
+    // Waits while a channel is full; the consumer is busy draining it, so short sleeps suffice
+    void waitForSpace(int& spins)
+    {
+        if (!spinBriefly(spins))
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    using CommandQueue = SpscByteQueue<1 << 16>;
+    using OutputQueue = SpscByteQueue<1 << 20>;
+
+    // std::cin for the engine: blocks in underflow until the app sends a command
+    class CommandBuf : public std::streambuf
+    {
+    public:
+        CommandBuf(CommandQueue& queue, Doorbell& bell, std::atomic<bool>& closed)
+            : queue(queue), bell(bell), closed(closed) {}
+
+    protected:
+        int_type underflow() override
+        {
+            int spins = 0;
+            while (true)
+            {
+                std::size_t n = queue.read(buf.data(), buf.size());
+                if (n == 0 && closed.load(std::memory_order_acquire))
+                    n = queue.read(buf.data(), buf.size());
+                if (n > 0)
+                {
+                    setg(buf.data(), buf.data(), buf.data() + n);
+                    return traits_type::to_int_type(buf[0]);
+                }
+                if (closed.load(std::memory_order_acquire))
+                    return traits_type::eof();
+                // an idle engine (the player is thinking) sleeps here until the next command
+                if (!spinBriefly(spins))
+                    bell.wait(Clock::time_point::max(), [&]
+                    {
+                        return !queue.empty() || closed.load(std::memory_order_acquire);
+                    });
+            }
+        }
+
+    private:
+        CommandQueue& queue;
+        Doorbell& bell;
+        std::atomic<bool>& closed;
+        std::array<char, 4096> buf{};
+    };
+
+    // std::cout for the engine: publishes a line at a time since Stockfish flushes with std::endl
+    class OutputBuf : public std::streambuf
+    {
+    public:
+        OutputBuf(OutputQueue& queue, Doorbell& bell) : queue(queue), bell(bell)
+        {
+            setp(buf.data(), buf.data() + buf.size());
+        }
+
+    protected:
+        int_type overflow(int_type c) override
+        {
+            publish();
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override
+        {
+            publish();
+            return 0;
+        }
+
+    private:
+        void publish()
+        {
+            const char* p = pbase();
+            std::size_t left = std::size_t(pptr() - pbase());
+            int spins = 0;
+            while (left > 0)
+            {
+                std::size_t n = queue.write(p, left);
+                p += n;
+                left -= n;
+                bell.ring();
+                if (left > 0)
+                    waitForSpace(spins);
+            }
+            setp(buf.data(), buf.data() + buf.size());
+        }
+
+        OutputQueue& queue;
+        Doorbell& bell;
+        std::array<char, 4096> buf{};
+    };
+}
+
+struct EmbeddedTransport::Channel
+{
+    CommandQueue commands;                  // app -> engine
+    OutputQueue output;                     // engine -> app
+    Doorbell commandBell;                   // wakes the engine thread
+    Doorbell outputBell;                    // wakes the reader
+    std::atomic<bool> inputClosed{false};   // app is done sending
+    std::atomic<bool> finished{false};      // engine thread returned
+    CommandBuf in{commands, commandBell, inputClosed};
+    OutputBuf out{output, outputBell};
+};
+
+// Input: None
+// Output: true if this binary was built with CHESS_EMBED_STOCKFISH
+bool EmbeddedTransport::available()
+{
+#ifdef CHESS_EMBED_STOCKFISH
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Redirects the standard streams and starts the engine thread
+// Input: None
+// Output: None (throws UciError if unavailable or another embedded engine is running)
+EmbeddedTransport::EmbeddedTransport()
+{
+#ifdef CHESS_EMBED_STOCKFISH
+    if (active.exchange(true))
+        throw UciError("an embedded engine is already running");
+
+    // pin the terminal streams before std::cin/std::cout stop pointing at the terminal
+    console().flush();
+    consoleInput();
+
+    channel = std::make_unique<Channel>();
+    savedIn = std::cin.rdbuf(&channel->in);
+    savedOut = std::cout.rdbuf(&channel->out);
+
+    Channel* ch = channel.get();
+    engineThread = std::thread([ch]
+    {
+        char name[] = "stockfish";
+        char* argv[] = {name, nullptr};
+        stockfish_embedded_main(1, argv);
+        std::cout.flush();
+        ch->finished.store(true, std::memory_order_release);
+        ch->outputBell.ring();
+    });
+#else
+    throw UciError("embedded engine not built in (configure with -DCHESS_EMBED_STOCKFISH=ON)");
+#endif
+}
+
+EmbeddedTransport::~EmbeddedTransport()
+{
+    close();
+}
+
+// Queues command bytes for the engine thread
+// Input: bytes, length
+// Output: None (throws UciError once the engine has exited)
+void EmbeddedTransport::write(const char* data, std::size_t len)
+{
+    if (!channel || channel->finished.load(std::memory_order_acquire))
+        throw UciError("engine is not running");
+
+    int spins = 0;
+    while (len > 0)
+    {
+        std::size_t n = channel->commands.write(data, len);
+        data += n;
+        len -= n;
+        channel->commandBell.ring();
+        if (len > 0)
+            waitForSpace(spins);
+    }
+}
+
+// Waits for engine output until the deadline
+// Input: destination buffer, its size, deadline
+// Output: bytes copied, 0 on timeout (throws UciError once the engine exited and its output is drained)
+std::size_t EmbeddedTransport::read(char* out, std::size_t cap, std::chrono::steady_clock::time_point deadline)
+{
+    if (!channel)
+        throw UciError("engine is not running");
+
+    int spins = 0;
+    while (true)
+    {
+        if (std::size_t n = channel->output.read(out, cap))
+            return n;
+        if (channel->finished.load(std::memory_order_acquire))
+        {
+            if (std::size_t n = channel->output.read(out, cap))
+                return n;
+            throw UciError("engine closed its output");
+        }
+        if (Clock::now() >= deadline)
+            return 0;
+        if (!spinBriefly(spins))
+        {
+            Channel& ch = *channel;
+            ch.outputBell.wait(deadline, [&]
+            {
+                return !ch.output.empty() || ch.finished.load(std::memory_order_acquire);
+            });
+        }
+    }
+}
+
+// Sends quit, joins the engine thread and restores std::cin/std::cout
+// Input: None
+// Output: None
+void EmbeddedTransport::close()
+{
+    if (!channel)
+        return;
+
+    static const char quit[] = "quit\n";
+    if (!channel->finished.load(std::memory_order_acquire))
+        channel->commands.write(quit, sizeof(quit) - 1);
+    channel->inputClosed.store(true, std::memory_order_release);
+    channel->commandBell.ring();
+
+    // keep draining so the engine never stalls on a full output channel while it shuts down
+    char sink[4096];
+    while (!channel->finished.load(std::memory_order_acquire))
+    {
+        if (channel->output.read(sink, sizeof(sink)) == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engineThread.join();
+
+    std::cin.rdbuf(savedIn);
+    std::cout.rdbuf(savedOut);
+    channel.reset();
+    active.store(false);
+}
@@ -0,0 +1,48 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Stockfish linked into the app and driven over in-memory lock-free channels
+*/
+
+#pragma once
+
+#include "engine_transport.h"
+
+#include <memory>
+#include <streambuf>
+#include <thread>
+
+// Runs the linked-in Stockfish on its own thread. Stockfish talks UCI over std::cin and
+// std::cout, so both are pointed at lock-free byte channels while it runs; only one embedded
+// engine can exist at a time and the app must use console() for terminal I/O meanwhile.
+class EmbeddedTransport : public EngineTransport
+{
+public:
+    // Input: None
+    // Output: true if this binary was built with CHESS_EMBED_STOCKFISH
+    static bool available();
+
+    // Redirects the standard streams and starts the engine thread
+    // Input: None
+    // Output: None (throws UciError if unavailable or another embedded engine is running)
+    EmbeddedTransport();
+    ~EmbeddedTransport() override;
+
+    EmbeddedTransport(const EmbeddedTransport&) = delete;
+    EmbeddedTransport& operator=(const EmbeddedTransport&) = delete;
+
+    void write(const char* data, std::size_t len) override;
+    std::size_t read(char* out, std::size_t cap, std::chrono::steady_clock::time_point deadline) override;
+
+    // Sends quit, joins the engine thread and restores std::cin/std::cout
+    void close() override;
+
+private:
+    struct Channel;
+
+    std::unique_ptr<Channel> channel;
+    std::thread engineThread;
+    std::streambuf* savedIn = nullptr;
+    std::streambuf* savedOut = nullptr;
+};
@@ -0,0 +1,39 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Fixed set of Stockfish processes that restart themselves after a crash
+*/
+
+#include "engine_pool.h"
+
+namespace
+{
+    const std::chrono::milliseconds HandshakeTimeout(10000);
+}
+
+EnginePool::EnginePool(std::string path, std::size_t size, std::vector<std::string> options)
+    : path(std::move(path)), options(std::move(options))
+{
+    engines.reserve(size);
+    for (std::size_t i = 0; i < size; i++)
+        engines.push_back(std::make_unique<UciEngine>());
+}
+
+// Starts the engine in slot and runs the UCI handshake if it is not running
+// Input: slot index
+// Output: None (throws UciError on failure)
+void EnginePool::ensureStarted(std::size_t slot)
+{
+    UciEngine& engine = *engines[slot];
+    if (engine.running())
+        return;
+
+    engine.start(path);
+    engine.send("uci");
+    engine.readUntil("uciok", HandshakeTimeout);
+    for (const std::string& opt : options)
+        engine.send(opt);
+    engine.send("isready");
+    engine.readUntil("readyok", HandshakeTimeout);
+}
@@ -0,0 +1,69 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Fixed set of Stockfish processes that restart themselves after a crash
+*/
+
+#pragma once
+
+#include "uci_engine.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One engine per slot; a slot must only be used by one thread at a time
+class EnginePool
+{
+public:
+    // Input: engine path, number of engines, setoption commands sent after "uci"
+    EnginePool(std::string path, std::size_t size, std::vector<std::string> options);
+
+    std::size_t size() const { return engines.size(); }
+
+    // Number of times an engine had to be restarted
+    std::size_t restarts() const { return restartCount.load(std::memory_order_relaxed); }
+
+    // Stops replacing engines that fail, so withEngine rethrows the first error at shutdown
+    void shutdown() { closing.store(true, std::memory_order_relaxed); }
+
+    // Runs fn on the engine in slot, restarting it when it fails. A failure on an engine that
+    // had been running is retried once on a fresh one; a failure on a fresh engine is the job's
+    // fault (a position that crashes it), so it is not retried.
+    // Input: slot index, callable taking UciEngine&
+    // Output: whatever fn returns (rethrows UciError when the retry fails too)
+    template <typename Fn>
+    auto withEngine(std::size_t slot, Fn&& fn) -> decltype(fn(std::declval<UciEngine&>()))
+    {
+        for (;;)
+        {
+            const bool fresh = !engines[slot]->running();
+            try
+            {
+                ensureStarted(slot);
+                return fn(*engines[slot]);
+            }
+            catch (const UciError&)
+            {
+                // the engine state is unknown after an error, so always replace it
+                engines[slot]->stop();
+                restartCount.fetch_add(1, std::memory_order_relaxed);
+                if (fresh || closing.load(std::memory_order_relaxed))
+                    throw;
+            }
+        }
+    }
+
+private:
+    void ensureStarted(std::size_t slot);
+
+    std::string path;
+    std::vector<std::string> options;
+    std::vector<std::unique_ptr<UciEngine>> engines;
+    std::atomic<std::size_t> restartCount{0};
+    std::atomic<bool> closing{false};
+};
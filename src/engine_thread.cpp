@@ -0,0 +1,224 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Runs engine I/O on its own thread and ponders while the player thinks
+*/
+
+#include "engine_thread.h"
+#include "analysis_cache.h"
+#include "metrics.h"
+#include "uci_engine.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // While searching or pondering, output is drained in slices this long so requests and
+    // shutdown are noticed quickly; an idle worker sleeps on its doorbell instead
+    const std::chrono::milliseconds PollSlice(2);
+    const std::chrono::milliseconds SearchTimeout(120000);
+    const std::chrono::milliseconds StopTimeout(10000);
+}
+
+// Starts the worker thread
+// Input: engine after its handshake (with Ponder enabled), cache, bell rung for every reply
+EngineThread::EngineThread(UciEngine& engine, AnalysisCache& cache, Doorbell& replyBell)
+    : engine(engine), cache(cache), replyBell(replyBell)
+{
+    worker = std::thread(&EngineThread::run, this);
+}
+
+// Stops any search in progress and joins the worker
+EngineThread::~EngineThread()
+{
+    quitting.store(true, std::memory_order_relaxed);
+    EngineRequest quit;
+    quit.type = EngineRequest::Quit;
+    post(std::move(quit));
+    worker.join();
+}
+
+// Queues a request for the engine thread
+// Input: request
+// Output: None
+void EngineThread::post(EngineRequest request)
+{
+    // the worker drains one request per search, so a full queue clears almost at once
+    while (!requests.push(std::move(request)))
+        std::this_thread::yield();
+    requestBell.ring();
+}
+
+void EngineThread::run()
+{
+    while (true)
+    {
+        EngineRequest request;
+        if (requests.pop(request))
+        {
+            if (request.type == EngineRequest::Quit)
+                break;
+            handle(request);
+            continue;
+        }
+
+        if (ponderPosition.empty())
+        {
+            // nothing to do until the player moves
+            requestBell.wait(Clock::time_point::max(), [&] { return !requests.empty(); });
+            continue;
+        }
+
+        // keep the pipe drained while pondering so the engine never blocks on a full buffer
+        try
+        {
+            engine.poll(PollSlice, [&](std::string_view line)
+            {
+                parseInfoLine(line, ponderResult);
+                return false;
+            });
+        }
+        catch (const UciError&)
+        {
+            // the next search reports the failure
+            ponderPosition.clear();
+        }
+    }
+
+    if (!ponderPosition.empty())
+    {
+        try
+        {
+            cancelPonder();
+        }
+        catch (const UciError&)
+        {
+        }
+    }
+}
+
+void EngineThread::handle(const EngineRequest& request)
+{
+    if (request.type == EngineRequest::Ponder)
+    {
+        try
+        {
+            if (!ponderPosition.empty())
+                cancelPonder();
+            startPonder(request);
+        }
+        catch (const UciError&)
+        {
+            ponderPosition.clear();
+        }
+        return;
+    }
+
+    const auto start = Clock::now();
+    EngineReply reply;
+    try
+    {
+        if (!ponderPosition.empty() && request.position == ponderPosition)
+        {
+            // the player made the predicted move: the search is already under way
+            engine.send("ponderhit");
+            reply.result = std::move(ponderResult);
+            ponderPosition.clear();
+            finishSearch(reply.result, ponderDeadline);
+            reply.ponderHit = true;
+            cache.store(request.key, reply.result);
+        }
+        else
+        {
+            if (!ponderPosition.empty())
+                cancelPonder();
+
+            if (cache.probe(request.key, reply.result) && reply.result.depth >= request.plan.cacheDepth)
+            {
+                reply.fromCache = true;
+            }
+            else
+            {
+                reply.result = SearchResult();
+                engine.send(request.position);
+                engine.send(request.plan.go);
+                finishSearch(reply.result, request.plan.deadline);
+                cache.store(request.key, reply.result);
+            }
+        }
+        reply.ok = true;
+    }
+    catch (const UciError& e)
+    {
+        ponderPosition.clear();
+        reply.error = e.what();
+    }
+    reply.latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+    while (!replies.push(std::move(reply)) && !quitting.load(std::memory_order_relaxed))
+        std::this_thread::yield();
+    replyBell.ring();
+}
+
+void EngineThread::startPonder(const EngineRequest& request)
+{
+    // a cached answer is instant anyway, so leave the engine idle
+    SearchResult cached;
+    if (cache.probe(request.key, cached) && cached.depth >= request.plan.cacheDepth)
+        return;
+
+    // limits apply from ponderhit, so the same deadline holds then
+    engine.send(request.position);
+    engine.send("go ponder" + request.plan.go.substr(2));
+    ponderPosition = request.position;
+    ponderDeadline = request.plan.deadline;
+    ponderResult = SearchResult();
+}
+
+// Sends stop to a ponder search and drops its result
+void EngineThread::cancelPonder()
+{
+    ponderPosition.clear();
+    engine.send("stop");
+    engine.readUntil("bestmove", StopTimeout);
+}
+
+// Reads search output in short slices until bestmove, sending stop at the deadline or on shutdown
+void EngineThread::finishSearch(SearchResult& result, std::chrono::milliseconds deadline)
+{
+    const auto start = Clock::now();
+    const auto giveUp = start + std::max(deadline, SearchTimeout);
+    const auto stopAt = deadline.count() > 0 ? start + deadline : giveUp;
+    const UciCommand command = engine.lastCommand();
+    bool stopSent = false;
+    auto onLine = [&](std::string_view line)
+    {
+        if (parseBestMoveLine(line, result))
+            return true;
+        parseInfoLine(line, result);
+        return false;
+    };
+
+    while (!engine.poll(PollSlice, onLine))
+    {
+        const auto now = Clock::now();
+        if (!stopSent && (now >= stopAt || quitting.load(std::memory_order_relaxed)))
+        {
+            engine.send("stop");
+            stopSent = true;
+        }
+        if (now >= giveUp)
+        {
+            metrics().timeouts.fetch_add(1, std::memory_order_relaxed);
+            throw UciError("timed out waiting for engine");
+        }
+    }
+
+    const auto elapsed = Clock::now() - start;
+    metrics().wait[std::size_t(command)].record(elapsed);
+    metrics().recordSearch(result, elapsed);
+}
@@ -0,0 +1,100 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Runs engine I/O on its own thread and ponders while the player thinks
+*/
+
+#pragma once
+
+#include "analysis.h"
+#include "doorbell.h"
+#include "search_policy.h"
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+class AnalysisCache;
+class UciEngine;
+
+// Work handed from the game loop to the engine thread
+struct EngineRequest
+{
+    enum Type { Search, Ponder, Quit };
+
+    Type type = Search;
+    std::string position;       // "position fen ..." command for the position to search
+    std::uint64_t key = 0;      // Zobrist key of that position
+    SearchPlan plan;            // limits for this search (a ponder search gets "go ponder ...")
+};
+
+// Answer to a Search request
+struct EngineReply
+{
+    bool ok = false;
+    SearchResult result;
+    std::string error;          // set when ok is false
+    bool ponderHit = false;     // the ponder search was on this position
+    bool fromCache = false;
+    std::chrono::microseconds latency{0};
+};
+
+// Owns the engine and the cache once started; the game loop only talks to it through two queues.
+// Exactly one thread may call post(), poll() and replyReady().
+class EngineThread
+{
+public:
+    // Starts the worker thread
+    // Input: engine after its handshake (with Ponder enabled), cache, bell rung for every reply
+    EngineThread(UciEngine& engine, AnalysisCache& cache, Doorbell& replyBell);
+
+    // Stops any search in progress and joins the worker
+    ~EngineThread();
+
+    EngineThread(const EngineThread&) = delete;
+    EngineThread& operator=(const EngineThread&) = delete;
+
+    // Queues a request for the engine thread
+    // Input: request
+    // Output: None
+    void post(EngineRequest request);
+
+    // Takes the next finished search, if any
+    // Input: reply to fill
+    // Output: false if nothing is ready
+    bool poll(EngineReply& reply) { return replies.pop(reply); }
+
+    // Output: true if poll() would return a reply
+    bool replyReady() const { return !replies.empty(); }
+
+private:
+    void run();
+    void handle(const EngineRequest& request);
+    void startPonder(const EngineRequest& request);
+
+    // Sends stop to a ponder search and drops its result
+    void cancelPonder();
+
+    // Reads search output in short slices until bestmove, sending stop at the deadline or on shutdown
+    void finishSearch(SearchResult& result, std::chrono::milliseconds deadline);
+
+    UciEngine& engine;
+    AnalysisCache& cache;
+
+    SpscQueue<EngineRequest, 16> requests;
+    SpscQueue<EngineReply, 16> replies;
+    Doorbell requestBell;               // wakes an idle worker
+    Doorbell& replyBell;
+    std::atomic<bool> quitting{false};
+
+    // the position the engine is pondering on, empty when idle
+    std::string ponderPosition;
+    std::chrono::milliseconds ponderDeadline{0};
+    SearchResult ponderResult;
+
+    std::thread worker;
+};
@@ -0,0 +1,58 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Byte transports that carry UCI text between the app and an engine
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <sys/types.h>
+
+// Moves raw UCI bytes to and from one engine; UciEngine does the line framing on top
+class EngineTransport
+{
+public:
+    virtual ~EngineTransport() = default;
+
+    // Sends all of data to the engine
+    // Input: bytes, length
+    // Output: None (throws UciError if the engine is gone)
+    virtual void write(const char* data, std::size_t len) = 0;
+
+    // Waits for engine output until the deadline
+    // Input: destination buffer, its size, deadline
+    // Output: bytes copied, 0 on timeout (throws UciError once the engine closed its output)
+    virtual std::size_t read(char* out, std::size_t cap, std::chrono::steady_clock::time_point deadline) = 0;
+
+    // Asks the engine to quit and releases it; safe to call twice
+    // Input: None
+    // Output: None
+    virtual void close() = 0;
+};
+
+// Stockfish as a child process connected by two pipes
+class PipeTransport : public EngineTransport
+{
+public:
+    // Forks and execs the engine binary at path
+    // Input: std::string path to executable
+    // Output: None (throws UciError on failure)
+    explicit PipeTransport(const std::string& path);
+    ~PipeTransport() override;
+
+    PipeTransport(const PipeTransport&) = delete;
+    PipeTransport& operator=(const PipeTransport&) = delete;
+
+    void write(const char* data, std::size_t len) override;
+    std::size_t read(char* out, std::size_t cap, std::chrono::steady_clock::time_point deadline) override;
+    void close() override;
+
+private:
+    pid_t pid = -1;
+    int toFd = -1;
+    int fromFd = -1;
+};
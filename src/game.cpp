@@ -0,0 +1,55 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Game state that tracks the current position and its compact UCI form
+*/
+
+#include "game.h"
+
+// Plays a move given in UCI notation
+// Input: move string like "e2e4" or "e7e8q"
+// Output: false if the move is not legal (position unchanged)
+bool Game::play(const std::string& uci)
+{
+    Move m = pos.parseUci(uci);
+    if (m == NoMove)
+        return false;
+
+    int rights = pos.castlingRights();
+    pos.doMove(m);
+
+    if (pos.halfmoveClock() == 0 || pos.castlingRights() != rights)
+    {
+        anchorFen = pos.fen();
+        sinceAnchor.clear();
+    }
+    else
+        sinceAnchor += " " + uci;
+
+    return true;
+}
+
+// Builds the engine command for the current position
+// Input: None
+// Output: "position fen <last irreversible position> [moves ...]"
+std::string Game::uciPosition() const
+{
+    if (sinceAnchor.empty())
+        return "position fen " + anchorFen;
+    return "position fen " + anchorFen + " moves" + sinceAnchor;
+}
+
+// Lists legal moves from the in-process move generator
+// Input: position
+// Output: vector of legal move strings
+std::vector<std::string> getLegalMoves(const Position& pos)
+{
+    MoveList list;
+    pos.legalMoves(list);
+
+    std::vector<std::string> legal;
+    for (Move m : list)
+        legal.push_back(Position::toUci(m));
+    return legal;
+}
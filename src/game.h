@@ -0,0 +1,45 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Game state that tracks the current position and its compact UCI form
+*/
+
+#pragma once
+
+#include "position.h"
+
+#include <string>
+#include <vector>
+
+// Keeps the position plus only the moves the engine needs to see
+class Game
+{
+public:
+    Game() : anchorFen(pos.fen()) {}
+
+    const Position& position() const { return pos; }
+
+    // Plays a move given in UCI notation
+    // Input: move string like "e2e4" or "e7e8q"
+    // Output: false if the move is not legal (position unchanged)
+    bool play(const std::string& uci);
+
+    // Builds the engine command for the current position
+    // Input: None
+    // Output: "position fen <last irreversible position> [moves ...]"
+    std::string uciPosition() const;
+
+private:
+    Position pos;
+
+    // Moves before a capture, pawn move or castling-rights change can never repeat,
+    // so the engine only needs the position after the last one and the moves since
+    std::string anchorFen;
+    std::string sinceAnchor;
+};
+
+// Lists legal moves from the in-process move generator
+// Input: position
+// Output: vector of legal move strings
+std::vector<std::string> getLegalMoves(const Position& pos);
@@ -0,0 +1,269 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: chess_load - plays many random games against chess --serve and reports moves/s and tail latency
+*/
+
+#include "game.h"
+#include "metrics.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int MaxEvents = 256;
+
+    struct LoadOptions
+    {
+        std::string host = "127.0.0.1";
+        int port = 7777;
+        std::size_t sessions = 100;
+        double durationSec = 10;
+        int plies = 40;             // client moves per game before starting a new one
+        unsigned seed = 1;
+        std::string outPath;        // JSON summary, one object
+    };
+
+    // One simulated player
+    struct Client
+    {
+        int fd = -1;
+        Game game;
+        std::mt19937 rng;
+        std::string in;
+        int plies = 0;
+        Clock::time_point sentAt;
+    };
+
+    struct LoadStats
+    {
+        LatencyHistogram latency;
+        std::uint64_t moves = 0;
+        std::uint64_t games = 0;
+        std::uint64_t errors = 0;
+    };
+
+    // Input: options, client to connect
+    // Output: false if the server cannot be reached
+    bool connectClient(const LoadOptions& options, Client& c)
+    {
+        c.fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(std::uint16_t(options.port));
+        if (c.fd < 0 || inet_pton(AF_INET, options.host.c_str(), &addr.sin_addr) != 1 ||
+            connect(c.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+        {
+            std::cerr << "connect " << options.host << ":" << options.port << ": " << std::strerror(errno) << "\n";
+            return false;
+        }
+        int on = 1;
+        setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        return true;
+    }
+
+    // Commands are a few bytes, so a blocking send of a whole line never stalls in practice
+    void sendLine(Client& c, const std::string& line)
+    {
+        std::string msg = line + "\n";
+        (void)!::send(c.fd, msg.data(), msg.size(), MSG_NOSIGNAL);
+    }
+
+    void newGame(Client& c, LoadStats& stats)
+    {
+        c.game = Game();
+        c.plies = 0;
+        stats.games++;
+        sendLine(c, "new");
+    }
+
+    // Plays a random legal move, or starts over when the game is done
+    void nextMove(Client& c, const LoadOptions& options, LoadStats& stats)
+    {
+        std::vector<std::string> moves = getLegalMoves(c.game.position());
+        if (moves.empty() || c.plies >= options.plies)
+        {
+            newGame(c, stats);
+            return;
+        }
+        const std::string& move = moves[std::uniform_int_distribution<std::size_t>(0, moves.size() - 1)(c.rng)];
+        c.game.play(move);
+        c.plies++;
+        c.sentAt = Clock::now();
+        sendLine(c, "move " + move);
+    }
+
+    // Input: reply line from the server
+    // Output: None (sends the client's next command unless the run is over)
+    void onReply(Client& c, std::string_view line, bool running, const LoadOptions& options, LoadStats& stats)
+    {
+        if (line.substr(0, 9) == "bestmove ")
+        {
+            stats.latency.record(Clock::now() - c.sentAt);
+            stats.moves++;
+            const std::string_view rest = line.substr(9);
+            const std::string_view move = rest.substr(0, rest.find(' '));
+            if (!c.game.play(std::string(move)))
+                stats.errors++;
+            // "bestmove d8h4 gameover": the engine's move ended the game
+            if (move.size() < rest.size())
+                c.plies = options.plies;
+        }
+        else if (line != "ok" && line != "gameover")
+        {
+            // illegal or error: resynchronise with a fresh game
+            stats.errors++;
+            c.plies = options.plies;
+        }
+
+        if (running)
+            nextMove(c, options, stats);
+    }
+
+    double ms(std::uint64_t ns)
+    {
+        return ns / 1e6;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    LoadOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try
+        {
+            if (arg == "--host" && hasValue) options.host = argv[++i];
+            else if (arg == "--port" && hasValue) options.port = std::stoi(argv[++i]);
+            else if (arg == "--sessions" && hasValue) options.sessions = std::stoul(argv[++i]);
+            else if (arg == "--duration" && hasValue) options.durationSec = std::stod(argv[++i]);
+            else if (arg == "--plies" && hasValue) options.plies = std::stoi(argv[++i]);
+            else if (arg == "--seed" && hasValue) options.seed = unsigned(std::stoul(argv[++i]));
+            else if (arg == "--out" && hasValue) options.outPath = argv[++i];
+            else
+            {
+                std::cerr << "Unknown argument: " << arg << "\n";
+                return 1;
+            }
+        }
+        catch (const std::logic_error&)
+        {
+            // std::stoi and friends throw invalid_argument or out_of_range
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Client> clients(options.sessions);
+    LoadStats stats;
+    for (std::size_t i = 0; i < clients.size(); i++)
+    {
+        Client& c = clients[i];
+        if (!connectClient(options, c))
+            return 1;
+        c.rng.seed(options.seed + unsigned(i));
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, c.fd, &ev);
+    }
+
+    // every client keeps exactly one command outstanding, so the offered load is closed-loop
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.durationSec));
+    for (Client& c : clients)
+        newGame(c, stats);
+
+    std::size_t open = clients.size();
+    std::size_t outstanding = clients.size();
+    epoll_event events[MaxEvents];
+    while (outstanding > 0 && open > 0)
+    {
+        const bool running = Clock::now() < end;
+        // once the run is over, give stragglers a moment to answer and then stop counting
+        if (!running && Clock::now() > end + std::chrono::seconds(5))
+            break;
+
+        int n = epoll_wait(epollFd, events, MaxEvents, 50);
+        for (int i = 0; i < n; i++)
+        {
+            Client& c = clients[events[i].data.u64];
+            char buf[4096];
+            ssize_t got = recv(c.fd, buf, sizeof(buf), 0);
+            if (got <= 0)
+            {
+                std::cerr << "server closed a session\n";
+                stats.errors++;
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+                open--;
+                outstanding--;
+                continue;
+            }
+            c.in.append(buf, std::size_t(got));
+
+            std::size_t pos;
+            while ((pos = c.in.find('\n')) != std::string::npos)
+            {
+                std::string line = c.in.substr(0, pos);
+                c.in.erase(0, pos + 1);
+                const bool more = Clock::now() < end;
+                onReply(c, line, more, options, stats);
+                if (!more)
+                    outstanding--;
+            }
+        }
+    }
+    const double secs = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (Client& c : clients)
+    {
+        if (c.fd >= 0)
+            ::close(c.fd);
+    }
+    ::close(epollFd);
+
+    const LatencyHistogram& h = stats.latency;
+    const double rate = secs > 0 ? stats.moves / secs : 0;
+    std::cout << options.sessions << " sessions, " << stats.moves << " moves in " << secs << " s: " << rate
+              << " moves/s, " << stats.games << " games, " << stats.errors << " errors\n"
+              << "latency ms: p50 " << ms(h.percentile(0.50)) << "  p90 " << ms(h.percentile(0.90)) << "  p99 "
+              << ms(h.percentile(0.99)) << "  p99.9 " << ms(h.percentile(0.999)) << "  max " << ms(h.maxNs()) << "\n";
+
+    if (!options.outPath.empty())
+    {
+        std::ofstream out(options.outPath);
+        out << "{\"sessions\":" << options.sessions << ",\"seconds\":" << secs << ",\"moves\":" << stats.moves
+            << ",\"moves_per_sec\":" << rate << ",\"games\":" << stats.games << ",\"errors\":" << stats.errors
+            << ",\"p50_ms\":" << ms(h.percentile(0.50)) << ",\"p90_ms\":" << ms(h.percentile(0.90))
+            << ",\"p99_ms\":" << ms(h.percentile(0.99)) << ",\"p999_ms\":" << ms(h.percentile(0.999))
+            << ",\"max_ms\":" << ms(h.maxNs()) << "}\n";
+        if (!out)
+        {
+            std::cerr << "Cannot write " << options.outPath << "\n";
+            return 1;
+        }
+    }
+    return stats.errors > 0 ? 2 : 0;
+}
@@ -1,208 +1,219 @@
 /*
 Author: Andrew Chen
 Class: ECE6122
-Last Date Modified: 11/26/2025
+Last Date Modified: 10/16/2026
 Description: Chess game using Stockfish engine, SFML for graphics, and command-line for user input
 */
 
 #include <iostream>
 #include <string>
 #include <vector>
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/wait.h>
-#include <sstream>
 #include <algorithm>
-#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
 #include <SFML/Graphics.hpp>
-
-std::array<std::array<char,8>,8> board =
-{{
-    {{'r','n','b','q','k','b','n','r'}},
-    {{'p','p','p','p','p','p','p','p'}},
-    {{' ',' ',' ',' ',' ',' ',' ',' '}},
-    {{' ',' ',' ',' ',' ',' ',' ',' '}},
-    {{' ',' ',' ',' ',' ',' ',' ',' '}},
-    {{' ',' ',' ',' ',' ',' ',' ',' '}},
-    {{'P','P','P','P','P','P','P','P'}},
-    {{'R','N','B','Q','K','B','N','R'}}
-}};
-
-// Reads from file descriptor until keyword appears
-// Input: int fd, std::string keyword
-// Output: std::string containing accumulated output
-std::string readUntil(int fd, const std::string& keyword)
+#include "uci_engine.h"
+#include "batch.h"
+#include "console.h"
+#include "doorbell.h"
+#include "embedded_engine.h"
+#include "game.h"
+#include "analysis.h"
+#include "analysis_cache.h"
+#include "engine_thread.h"
+#include "metrics.h"
+#include "renderer.h"
+#include "search_policy.h"
+#include "server.h"
+#include "spsc_queue.h"
+
+// Per-command deadlines for engine replies
+const std::chrono::milliseconds HandshakeTimeout(10000);
+
+// The game engine plays weakened; its cache entries are kept apart from full-strength analysis
+const std::string SkillOption = "setoption name Skill Level value 3";
+
+// The weakened game engine gains nothing from a big hash table; the batch and server pools size
+// theirs from free memory instead
+const int GameMaxHashMB = 256;
+
+// Input and engine replies wake the game loop at once; SFML cannot ring a doorbell, so window
+// events are only picked up this often while nothing else happens
+const std::chrono::milliseconds WindowTick(16);
+
+// Console lines handed from the reader thread to the game loop
+struct InputChannel
 {
-    std::string acc;
-    char buf[4096];
-
-    while (true)
-    {
-        int n = read(fd, buf, sizeof(buf) - 1);
-        if (n <= 0) continue;
-        buf[n] = 0;
-        acc += buf;
-
-        if (acc.find(keyword) != std::string::npos)
-            return acc;
-    }
-}
-
-// Extracts best move from Stockfish
-// Input: std::string output from engine
-// Output: 4-character move string like "e2e4"
-std::string parseBestMove(const std::string& out)
-{
-    size_t pos = out.find("bestmove ");
-    if (pos == std::string::npos) return "";
-    pos += 9;
-    return out.substr(pos, 4);
-}
+    SpscQueue<std::string, 64> lines;
+    Doorbell space;     // rung by the game loop after it takes lines
+};
 
 // Prints ASCII board
-// Input: board array
+// Input: position
 // Output: None (prints to stdout)
-void printBoard(const std::array<std::array<char,8>,8>& board)
+void printBoard(const Position& pos)
 {
-    std::cout << "\n  +-----------------+\n";
+    console() << "\n  +-----------------+\n";
     for (int r = 0; r < 8; r++)
     {
-        std::cout << 8 - r << " | ";
+        console() << 8 - r << " | ";
         for (int c = 0; c < 8; c++)
         {
-            char p = board[r][c];
+            char p = pos.pieceChar(makeSquare(c, 7 - r));  // flip row for white at bottom
             if (p == ' ') p = '.';
-            std::cout << p << " ";
+            console() << p << " ";
         }
-        std::cout << "|\n";
+        console() << "|\n";
     }
-    std::cout << "  +-----------------+\n";
-    std::cout << "    a b c d e f g h\n\n";
+    console() << "  +-----------------+\n";
+    console() << "    a b c d e f g h\n\n";
 }
 
-// Applies a move to the board array
-// Input: board array (by reference), move string like "e2e4"
-// Output: board is updated in place
-void applyMove(std::array<std::array<char,8>,8>& board, const std::string& mv)
+// Pumps pending window events and redraws the board if it changed
+// Input: window, renderer, position
+void displayBoard(sf::RenderWindow &window, BoardRenderer &renderer, const Position& pos)
 {
-    int c1 = mv[0] - 'a';
-    int r1 = 7 - (mv[1] - '1');  // flip row for white at bottom
-    int c2 = mv[2] - 'a';
-    int r2 = 7 - (mv[3] - '1');
-
-    char piece = board[r1][c1];
-    board[r1][c1] = ' ';
-    board[r2][c2] = piece;
-}
-
-// Queries Stockfish for legal moves
-// Input: engine fd, write fd, moves string
-// Output: vector of legal move strings
-std::vector<std::string> getLegalMoves(int fd, int toEngineFd, const std::string& moves)
-{
-    auto send = [&](const std::string& s)
+    sf::Event event;
+    while (window.pollEvent(event))
     {
-        write(toEngineFd, s.c_str(), s.size());
-    };
-
-    send("position startpos moves" + moves + "\n");
-    send("go perft 1\n");
-
-    std::vector<std::string> legal;
-    std::string out;
-    char buf[4096];
-
-    while (true)
-    {
-        int n = read(fd, buf, sizeof(buf) - 1);
-        if (n <= 0) continue;
-        buf[n] = 0;
-        out += buf;
-
-        if (out.find("Nodes searched") != std::string::npos)
-            break;
+        if (event.type == sf::Event::Closed)
+            window.close();
+        else if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus)
+            renderer.invalidate();
     }
 
-    std::stringstream ss(out);
-    std::string token;
-    while (ss >> token)
-    {
-        if (token.size() >= 4 && token[2] >= 'a' && token[2] <= 'h')
-            legal.push_back(token.substr(0,4));
-    }
+    if (!window.isOpen())
+        return;
 
-    return legal;
+    const auto start = std::chrono::steady_clock::now();
+    renderer.setPosition(pos);
+    if (renderer.render(window))
+        metrics().frame.record(std::chrono::steady_clock::now() - start);
 }
 
-// Maps board char to chess font char
-// Input: char piece
-// Output: char used in chess font
-char mapPieceToFont(char piece)
+// Forwards console moves to the game loop; runs on its own thread so the window stays live
+// Input: channel shared with the game loop, bell that wakes the game loop
+// Output: None (pushes "quit" at end of input)
+void readConsole(InputChannel& input, Doorbell& wake)
 {
-    switch(piece)
+    auto forward = [&](std::string line)
     {
-        case 'B': return 'n'; case 'N': return 'j'; case 'K': return 'l';
-        case 'Q': return 'w'; case 'R': return 't'; case 'P': return 'o';
-        case 'b': return 'n'; case 'n': return 'j'; case 'k': return 'l';
-        case 'q': return 'w'; case 'r': return 't'; case 'p': return 'o';
-        case ' ': return ' ';
-        default: return ' ';
-    }
+        // only a paste of more than 64 moves ever finds the queue full
+        input.space.wait(Doorbell::Clock::time_point::max(), [&] { return !input.lines.full(); });
+        input.lines.push(std::move(line));
+        wake.ring();
+    };
+
+    std::string move;
+    while (consoleInput() >> move)
+        forward(move);
+    forward("quit");
 }
 
-// Renders SFML board
-// Input: window, tileSize, font, board array
-void displayBoard(sf::RenderWindow &window, float tileSize, sf::Font &font, const std::array<std::array<char,8>,8>& board)
+// Main program loop
+int main(int argc, char* argv[])
 {
-    sf::Color lightColor(200, 180, 140);
-    sf::Color darkColor(120, 80, 50);
-
-    window.clear();
-
-    for (int r = 0; r < 8; r++)
+    // headless batch analysis: chess --batch positions.epd [--out f] [--engines n] [--depth d] [--engine-path p]
+    //   exits 2 when any position ends in an error row, so scripts can tell a partial run from a clean one
+    // cache prebuild: chess --build-cache games.pgn [--cache f] [--plies n] [--depth d] [--engines n]
+    // game server: chess --serve port [--io-threads n] [--sessions n] [--engines n] [--depth d | --movetime ms]
+    // game engine: --engine embedded|pipe (batch modes always run engine processes)
+    // metrics for any mode: --metrics path/base [--metrics-interval ms] writes base.prom and base.json
+    // search policy: [--depth d] [--movetime ms] [--clock min+sec] [--target-p95 ms] [--threads n] [--hash mb]
+    BatchOptions batch;
+    SearchLimits limits;
+    int threads = 0;
+    std::string backend = EmbeddedTransport::available() ? "embedded" : "pipe";
+    std::string metricsPath;
+    int metricsIntervalMs = 1000;
+    bool buildCache = false;
+    ServerOptions server;
+    bool serve = false;
+    for (int i = 1; i < argc; i++)
     {
-        for (int c = 0; c < 8; c++)
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try
         {
-            sf::RectangleShape sq(sf::Vector2f(tileSize, tileSize));
-            sq.setPosition(c * tileSize, r * tileSize);
-
-            if ((r + c) % 2 == 0)
+            if (arg == "--batch" && hasValue) batch.inputPath = argv[++i];
+            else if (arg == "--out" && hasValue) batch.outputPath = argv[++i];
+            else if (arg == "--engines" && hasValue) batch.engines = std::stoul(argv[++i]);
+            else if (arg == "--depth" && hasValue) batch.depth = std::stoi(argv[++i]);
+            else if (arg == "--engine-path" && hasValue) batch.enginePath = argv[++i];
+            else if (arg == "--engine" && hasValue) backend = argv[++i];
+            else if (arg == "--metrics" && hasValue) metricsPath = argv[++i];
+            else if (arg == "--metrics-interval" && hasValue) metricsIntervalMs = std::stoi(argv[++i]);
+            else if (arg == "--movetime" && hasValue) limits.movetimeMs = std::stoi(argv[++i]);
+            else if (arg == "--clock" && hasValue)
             {
-                sq.setFillColor(lightColor);
+                // "5+3": five minutes each plus three seconds per move
+                std::string clock = argv[++i];
+                std::size_t plus = clock.find('+');
+                limits.baseMs = int(std::stod(clock.substr(0, plus)) * 60000);
+                limits.incMs = plus == std::string::npos ? 0 : int(std::stod(clock.substr(plus + 1)) * 1000);
             }
+            else if (arg == "--target-p95" && hasValue) limits.targetP95Ms = std::stoi(argv[++i]);
+            else if (arg == "--threads" && hasValue) threads = std::stoi(argv[++i]);
+            else if (arg == "--hash" && hasValue) batch.hashMB = std::stoi(argv[++i]);
+            else if (arg == "--serve" && hasValue) { server.port = std::stoi(argv[++i]); serve = true; }
+            else if (arg == "--io-threads" && hasValue) server.ioThreads = std::stoul(argv[++i]);
+            else if (arg == "--sessions" && hasValue) server.maxSessions = std::stoul(argv[++i]);
+            else if (arg == "--build-cache" && hasValue) { batch.inputPath = argv[++i]; buildCache = true; }
+            else if (arg == "--cache" && hasValue) batch.cachePath = argv[++i];
+            else if (arg == "--cache-size" && hasValue) batch.cacheSizeMB = std::stoul(argv[++i]);
+            else if (arg == "--plies" && hasValue) batch.maxPlies = std::stoi(argv[++i]);
+            else if (arg == "--no-cache") batch.cachePath.clear();
             else
             {
-                sq.setFillColor(darkColor);
-            }
-
-            window.draw(sq);
-
-            char p = board[r][c];
-            if (p != ' ')
-            {
-                sf::Text piece;
-                piece.setFont(font);
-                piece.setString(std::string(1, mapPieceToFont(p)));
-                piece.setCharacterSize(tileSize * 0.9f);
-
-                sf::FloatRect b = piece.getLocalBounds();
-                piece.setOrigin(b.left + b.width/2, b.top + b.height/2);
-                piece.setPosition(c * tileSize + tileSize/2, r * tileSize + tileSize/2);
-
-                piece.setFillColor(isupper(p) ? sf::Color::White : sf::Color::Black);
-                window.draw(piece);
+                std::cerr << "Unknown argument: " << arg << "\n";
+                return 1;
             }
         }
+        catch (const std::logic_error&)
+        {
+            // std::stoi and friends throw invalid_argument or out_of_range
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n";
+            return 1;
+        }
     }
 
-    window.display();
-}
-
-// Main program loop
-int main()
-{
+    // unset engine resources are sized for this machine
+    if (threads <= 0)
+        threads = recommendedThreads();
+    const int hashMB = batch.hashMB > 0 ? batch.hashMB : recommendedHashMB(1, GameMaxHashMB);
+    limits.depth = batch.depth;
+    SearchPolicy policy(limits);
+
+    std::unique_ptr<MetricsExporter> exporter;
+    if (!metricsPath.empty())
+        exporter = std::make_unique<MetricsExporter>(metricsPath, std::chrono::milliseconds(metricsIntervalMs));
+
+    if (buildCache)
+        return runCacheBuild(batch);
+    if (!batch.inputPath.empty())
+        return runBatch(batch);
+    if (serve)
+    {
+        // every game gets the same fixed search, so modes that follow one game's clock or
+        // latency have nothing to adapt to
+        if (limits.baseMs > 0 || limits.targetP95Ms > 0)
+        {
+            std::cerr << "--clock and --target-p95 apply to a single game; use --depth or --movetime with --serve\n";
+            return 1;
+        }
+        server.engines = batch.engines;
+        server.enginePath = batch.enginePath;
+        server.hashMB = batch.hashMB;
+        server.cachePath = batch.cachePath;
+        server.cacheSizeMB = batch.cacheSizeMB;
+        server.plan = policy.plan(Black);
+        return runServer(server);
+    }
     // init window
-    std::cout << "Starting up...\n";
+    console() << "Starting up...\n";
     const float tileSize = 80.f;
     sf::RenderWindow window(sf::VideoMode(8 * tileSize, 8 * tileSize), "SFML Chess Board");
 
@@ -212,91 +223,154 @@ int main()
     {
         std::cerr << "Failed to load font\n";
     }
+    BoardRenderer renderer(tileSize, font);
 
-    // create pipes for engine comm
-    int toEngine[2]; int fromEngine[2];
-    pipe(toEngine); pipe(fromEngine);
-    pid_t pid = fork();
-    if (pid == 0)
+    // start engine
+    UciEngine engine;
+    try
     {
-        dup2(toEngine[0], STDIN_FILENO);
-        dup2(fromEngine[1], STDOUT_FILENO);
-        close(toEngine[1]);
-        close(fromEngine[0]);
-
-        execlp("../src/stockfish", "stockfish", nullptr);
-        perror("execlp failed");
-        exit(1);
+        if (backend == "embedded")
+            engine.start(std::make_unique<EmbeddedTransport>());
+        else if (backend == "pipe")
+            engine.start(batch.enginePath);
+        else
+            throw UciError("unknown engine backend " + backend);
+
+        // init engine
+        engine.send("uci");
+        engine.readUntil("uciok", HandshakeTimeout);
+        engine.send(SkillOption);
+        engine.send("setoption name Ponder value true");
+        engine.send("setoption name Threads value " + std::to_string(threads));
+        engine.send("setoption name Hash value " + std::to_string(hashMB));
+        engine.send("isready");
+        engine.readUntil("readyok", HandshakeTimeout);
+        console() << "Engine: " << threads << " threads, " << hashMB << " MB hash, " << policy.describe() << "\n";
+    }
+    catch (const UciError& e)
+    {
+        std::cerr << "Engine failed to start: " << e.what() << "\n";
+        return 1;
     }
 
-    // close unused pipe ends
-    close(toEngine[0]);
-    close(fromEngine[1]);
-    auto send = [&](const std::string& s) { write(toEngine[1], s.c_str(), s.size()); };
-
-    // init engine
-    send("uci\n");
-    readUntil(fromEngine[0], "uciok");
-    send("setoption name Skill Level value 3\n");
-    send("isready\n");
-    readUntil(fromEngine[0], "readyok");
-
-    // game loop
-    std::string moves;
-    while (true)
+    // positions searched before (by this or any other process) come from the cache
+    AnalysisCache cache;
+    if (!batch.cachePath.empty())
+        cache.open(batch.cachePath, batch.cacheSizeMB, SkillOption);
+
+    // console input, engine I/O and the window each get their own thread
+    static InputChannel input;
+    static Doorbell wake;
+    std::thread(readConsole, std::ref(input), std::ref(wake)).detach();
+    EngineThread engineThread(engine, cache, wake);
+
+    // game loop: the window is serviced every tick whoever's turn it is
+    Game game;
+    bool userToMove = true;
+    auto turnStart = std::chrono::steady_clock::now();
+    printBoard(game.position());
+    console() << "Your move: " << std::flush;
+    while (window.isOpen())
     {
-        // show
-        printBoard(board);
-        displayBoard(window, tileSize, font, board);
+        displayBoard(window, renderer, game.position());
 
-        // get user move with validation check
-        auto legalMoves = getLegalMoves(fromEngine[0], toEngine[1], moves);
         std::string userMove;
-        while (true)
+        while (input.lines.pop(userMove))
         {
-            std::cout << "Your move: ";
-            std::cin >> userMove;
-
             if (userMove == "quit")
             {
-                send("quit\n");
-                return 0;
+                window.close();
+                break;
+            }
+            if (!userToMove)
+            {
+                console() << "Wait for the engine's move.\n";
+                continue;
+            }
+
+            // make move with validation check
+            auto legalMoves = getLegalMoves(game.position());
+            if (std::find(legalMoves.begin(), legalMoves.end(), userMove) == legalMoves.end())
+            {
+                console() << "Illegal move. Try again.\nYour move: " << std::flush;
+                continue;
             }
+            game.play(userMove);
+            policy.charge(White, std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - turnStart));
+            printBoard(game.position());
 
-            if (std::find(legalMoves.begin(), legalMoves.end(), userMove) != legalMoves.end())
+            if (getLegalMoves(game.position()).empty())
             {
+                console() << "Game over.\n";
+                window.close();
                 break;
             }
 
-            std::cout << "Illegal move. Try again.\n";
+            EngineRequest search;
+            search.position = game.uciPosition();
+            search.key = game.position().key();
+            search.plan = policy.plan(Black);
+            engineThread.post(std::move(search));
+            userToMove = false;
         }
+        input.space.ring();
 
-        // make move
-        applyMove(board, userMove);
-        moves += " " + userMove;
-
-        // show
-        printBoard(board);
-        displayBoard(window, tileSize, font, board);
-        
-        // wait
-        sleep(1);
-
-        // get engine move
-        send("position startpos moves" + moves + "\n");
-        send("go depth 12\n");
-        std::string result = readUntil(fromEngine[0], "bestmove");
-        std::string engineMove = parseBestMove(result);
-
-        // make engine move
-        std::cout << "Engine plays: " << engineMove << "\n";
-        applyMove(board, engineMove);
-        moves += " " + engineMove;
-    }
+        EngineReply reply;
+        while (window.isOpen() && engineThread.poll(reply))
+        {
+            if (!reply.ok)
+            {
+                std::cerr << "Engine error: " << reply.error << "\n";
+                return 1;
+            }
+
+            // make engine move
+            const std::string& engineMove = reply.result.bestmove;
+            console() << "Engine plays: " << engineMove << " (" << reply.latency.count() / 1000.0 << " ms"
+                      << (reply.ponderHit ? ", ponder hit" : reply.fromCache ? ", cached" : "") << ")\n";
+            policy.observe(reply.result, reply.latency, !reply.ponderHit && !reply.fromCache);
+            policy.charge(Black, std::chrono::duration_cast<std::chrono::milliseconds>(reply.latency));
+            if (policy.timed())
+                console() << "Clock: you " << policy.clockMs(White) / 1000.0 << " s, engine "
+                          << policy.clockMs(Black) / 1000.0 << " s\n";
+            if (!game.play(engineMove))
+            {
+                std::cerr << "Engine returned an illegal move: " << engineMove << "\n";
+                return 1;
+            }
+            printBoard(game.position());
+
+            if (getLegalMoves(game.position()).empty())
+            {
+                console() << "Game over.\n";
+                window.close();
+                break;
+            }
+
+            // think on the expected reply while the player does
+            Game predicted = game;
+            if (!reply.result.ponder.empty() && predicted.play(reply.result.ponder))
+            {
+                EngineRequest ponder;
+                ponder.type = EngineRequest::Ponder;
+                ponder.position = predicted.uciPosition();
+                ponder.key = predicted.position().key();
+                ponder.plan = policy.plan(Black);
+                engineThread.post(std::move(ponder));
+            }
 
-    close(toEngine[1]);
-    close(fromEngine[0]);
-    wait(nullptr);
+            userToMove = true;
+            turnStart = std::chrono::steady_clock::now();
+            console() << "Your move: " << std::flush;
+        }
+
+        wake.wait(std::chrono::steady_clock::now() + WindowTick, [&]
+        {
+            return !input.lines.empty() || engineThread.replyReady();
+        });
+    }
 
+    renderer.printStats(console());
     return 0;
 }
@@ -0,0 +1,376 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Lock-free latency histograms and search telemetry, exported as Prometheus text and JSON
+*/
+
+#include "metrics.h"
+#include "analysis.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const char* const CommandNames[] = {
+        "uci", "isready", "setoption", "ucinewgame", "position", "go", "stop", "ponderhit", "quit", "other"
+    };
+    static_assert(sizeof(CommandNames) / sizeof(CommandNames[0]) == std::size_t(UciCommand::Count),
+                  "one name per command");
+
+    // Prometheus buckets: every power of two from 1 us to about 69 s
+    const int FirstEdge = 10;
+    const int LastEdge = 36;
+
+    // Raises target to value unless it is already larger
+    void storeMax(std::atomic<std::uint64_t>& target, std::uint64_t value)
+    {
+        std::uint64_t seen = target.load(std::memory_order_relaxed);
+        while (seen < value && !target.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Writes the buckets, sum and count of one histogram series
+    // Input: stream, metric name, label text like command="go", histogram
+    void writePromHistogram(std::ostream& out, const char* name, const std::string& labels,
+                            const LatencyHistogram& h)
+    {
+        const std::string sep = labels.empty() ? "" : ",";
+        char le[32];
+        for (int e = FirstEdge; e <= LastEdge; e++)
+        {
+            std::snprintf(le, sizeof(le), "%g", double(std::uint64_t(1) << e) / 1e9);
+            out << name << "_bucket{" << labels << sep << "le=\"" << le << "\"} "
+                << h.countBelow(std::uint64_t(1) << e) << "\n";
+        }
+        out << name << "_bucket{" << labels << sep << "le=\"+Inf\"} " << h.count() << "\n";
+        const std::string braces = labels.empty() ? "" : "{" + labels + "}";
+        out << name << "_sum" << braces << " " << h.sumNs() / 1e9 << "\n";
+        out << name << "_count" << braces << " " << h.count() << "\n";
+    }
+
+    // Writes one histogram's summary as a JSON object, in microseconds
+    void writeJsonHistogram(std::ostream& out, const LatencyHistogram& h)
+    {
+        const std::uint64_t n = h.count();
+        out << "{\"count\": " << n << ", \"mean_us\": " << (n ? h.sumNs() / 1e3 / n : 0.0)
+            << ", \"p50_us\": " << h.percentile(0.50) / 1e3 << ", \"p90_us\": " << h.percentile(0.90) / 1e3
+            << ", \"p99_us\": " << h.percentile(0.99) / 1e3 << ", \"max_us\": " << h.maxNs() / 1e3 << "}";
+    }
+
+    // Writes to path.tmp and renames it over path
+    template <typename Writer>
+    bool replaceFile(const std::string& path, Writer write)
+    {
+        const std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            if (!out)
+                return false;
+            write(out);
+            if (!out)
+                return false;
+        }
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+}
+
+// Input: command line as sent to the engine
+// Output: its type, by the first word
+UciCommand classifyCommand(std::string_view cmd)
+{
+    std::string_view word = cmd.substr(0, cmd.find_first_of(" \n"));
+    if (word == "go") return UciCommand::Go;
+    if (word == "position") return UciCommand::Position;
+    if (word == "isready") return UciCommand::IsReady;
+    if (word == "stop") return UciCommand::Stop;
+    if (word == "ponderhit") return UciCommand::PonderHit;
+    if (word == "setoption") return UciCommand::SetOption;
+    if (word == "ucinewgame") return UciCommand::NewGame;
+    if (word == "uci") return UciCommand::Uci;
+    if (word == "quit") return UciCommand::Quit;
+    return UciCommand::Other;
+}
+
+// Input: command type
+// Output: lowercase label used in the exported metrics
+const char* commandName(UciCommand command)
+{
+    return CommandNames[std::size_t(command)];
+}
+
+// Input: value in ns
+// Output: bucket index
+int LatencyHistogram::bucketOf(std::uint64_t ns)
+{
+    if (ns < SubBuckets)
+        return int(ns);
+    int e = 63 - __builtin_clzll(ns);
+    return (e - SubBits + 1) * SubBuckets + int((ns >> (e - SubBits)) & (SubBuckets - 1));
+}
+
+// Input: bucket index
+// Output: smallest value falling into it
+std::uint64_t LatencyHistogram::bucketLow(int index)
+{
+    if (index < SubBuckets)
+        return std::uint64_t(index);
+    int e = index / SubBuckets + SubBits - 1;
+    return std::uint64_t(SubBuckets + index % SubBuckets) << (e - SubBits);
+}
+
+// Input: duration in nanoseconds
+// Output: None
+void LatencyHistogram::record(std::uint64_t ns)
+{
+    counts[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(ns, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    storeMax(largest, ns);
+}
+
+// Input: fraction in [0, 1]
+// Output: upper edge of the bucket holding that quantile, in ns (0 if empty)
+std::uint64_t LatencyHistogram::percentile(double p) const
+{
+    // sum the buckets rather than trusting total, which may be a few samples ahead
+    std::uint64_t n = 0;
+    for (const auto& c : counts)
+        n += c.load(std::memory_order_relaxed);
+    if (n == 0)
+        return 0;
+
+    const std::uint64_t rank = std::max<std::uint64_t>(1, std::uint64_t(p * n + 0.5));
+    std::uint64_t seen = 0;
+    for (int i = 0; i < Buckets; i++)
+    {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return std::min(i + 1 < Buckets ? bucketLow(i + 1) - 1 : ~std::uint64_t(0), maxNs());
+    }
+    return maxNs();
+}
+
+// Input: upper edge in ns
+// Output: number of samples below it (exact when it is a power of two)
+std::uint64_t LatencyHistogram::countBelow(std::uint64_t ns) const
+{
+    std::uint64_t n = 0;
+    for (int i = 0; i < Buckets && bucketLow(i) < ns; i++)
+        n += counts[i].load(std::memory_order_relaxed);
+    return n;
+}
+
+// Keeps the final info of a search for the recent-moves table and the totals
+// Input: finished search, wall time it took
+// Output: None
+void Metrics::recordSearch(const SearchResult& result, std::chrono::steady_clock::duration latency)
+{
+    searchLatency.record(latency);
+    nodes.fetch_add(result.nodes, std::memory_order_relaxed);
+    const std::uint64_t sequence = searches.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    TelemetrySlot& slot = recent[(sequence - 1) % RecentSearches];
+    std::uint64_t version = slot.version.load(std::memory_order_relaxed);
+    // odd means another writer lapped the table and is still filling this slot; drop ours
+    if ((version & 1) || !slot.version.compare_exchange_strong(version, version + 1, std::memory_order_acquire))
+        return;
+    // readers that see any of the new fields must also see the odd version
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const std::uint64_t values[] = {
+        sequence,
+        std::uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(latency).count()),
+        result.nodes, result.nps, result.tbhits,
+        std::uint64_t(result.depth), std::uint64_t(result.seldepth), std::uint64_t(result.hashfull),
+        std::uint64_t(result.timeMs), std::uint64_t(std::int64_t(result.score)), std::uint64_t(result.mate)
+    };
+    for (std::size_t i = 0; i < slot.fields.size(); i++)
+        slot.fields[i].store(values[i], std::memory_order_relaxed);
+    slot.version.store(version + 2, std::memory_order_release);
+}
+
+bool Metrics::readSlot(const TelemetrySlot& slot, SearchTelemetry& out) const
+{
+    for (int attempt = 0; attempt < 8; attempt++)
+    {
+        const std::uint64_t before = slot.version.load(std::memory_order_acquire);
+        if (before == 0)
+            return false;
+        if (before & 1)
+            continue;
+
+        std::uint64_t v[11];
+        for (std::size_t i = 0; i < slot.fields.size(); i++)
+            v[i] = slot.fields[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != before)
+            continue;
+
+        out.sequence = v[0];
+        out.latencyUs = v[1];
+        out.nodes = v[2];
+        out.nps = v[3];
+        out.tbhits = v[4];
+        out.depth = int(v[5]);
+        out.seldepth = int(v[6]);
+        out.hashfull = int(v[7]);
+        out.timeMs = int(v[8]);
+        out.score = int(std::int64_t(v[9]));
+        out.mate = v[10] != 0;
+        return true;
+    }
+    return false;
+}
+
+// Input: stream
+// Output: None (writes the Prometheus text exposition format)
+void Metrics::writePrometheus(std::ostream& out) const
+{
+    out << "# HELP chess_uci_send_seconds Time to hand a command to the engine\n"
+        << "# TYPE chess_uci_send_seconds histogram\n";
+    for (std::size_t c = 0; c < send.size(); c++)
+    {
+        if (send[c].count() > 0)
+            writePromHistogram(out, "chess_uci_send_seconds",
+                               std::string("command=\"") + CommandNames[c] + "\"", send[c]);
+    }
+
+    out << "# HELP chess_uci_wait_seconds Time waiting for the engine's answer to a command\n"
+        << "# TYPE chess_uci_wait_seconds histogram\n";
+    for (std::size_t c = 0; c < wait.size(); c++)
+    {
+        if (wait[c].count() > 0)
+            writePromHistogram(out, "chess_uci_wait_seconds",
+                               std::string("command=\"") + CommandNames[c] + "\"", wait[c]);
+    }
+
+    out << "# HELP chess_frame_seconds displayBoard calls that presented a frame\n"
+        << "# TYPE chess_frame_seconds histogram\n";
+    writePromHistogram(out, "chess_frame_seconds", "", frame);
+
+    out << "# HELP chess_search_seconds Wall time of each engine search\n"
+        << "# TYPE chess_search_seconds histogram\n";
+    writePromHistogram(out, "chess_search_seconds", "", searchLatency);
+
+    out << "# HELP chess_search_nodes_total Nodes searched by the engine\n"
+        << "# TYPE chess_search_nodes_total counter\n"
+        << "chess_search_nodes_total " << nodes.load(std::memory_order_relaxed) << "\n";
+    out << "# HELP chess_uci_timeouts_total Engine commands that missed their deadline\n"
+        << "# TYPE chess_uci_timeouts_total counter\n"
+        << "chess_uci_timeouts_total " << timeouts.load(std::memory_order_relaxed) << "\n";
+
+    // the latest search as gauges, for dashboards that only want "now"
+    SearchTelemetry last;
+    const std::uint64_t n = searches.load(std::memory_order_relaxed);
+    if (n > 0 && readSlot(recent[(n - 1) % RecentSearches], last))
+    {
+        out << "# TYPE chess_last_search_depth gauge\nchess_last_search_depth " << last.depth << "\n"
+            << "# TYPE chess_last_search_seldepth gauge\nchess_last_search_seldepth " << last.seldepth << "\n"
+            << "# TYPE chess_last_search_nps gauge\nchess_last_search_nps " << last.nps << "\n"
+            << "# TYPE chess_last_search_hashfull_ratio gauge\nchess_last_search_hashfull_ratio "
+            << last.hashfull / 1000.0 << "\n";
+    }
+}
+
+// Input: stream
+// Output: None (writes the same data plus recent searches as JSON)
+void Metrics::writeJson(std::ostream& out) const
+{
+    out << "{\n  \"send\": {";
+    const char* sep = "";
+    for (std::size_t c = 0; c < send.size(); c++)
+    {
+        if (send[c].count() == 0)
+            continue;
+        out << sep << "\n    \"" << CommandNames[c] << "\": ";
+        writeJsonHistogram(out, send[c]);
+        sep = ",";
+    }
+    out << "\n  },\n  \"wait\": {";
+    sep = "";
+    for (std::size_t c = 0; c < wait.size(); c++)
+    {
+        if (wait[c].count() == 0)
+            continue;
+        out << sep << "\n    \"" << CommandNames[c] << "\": ";
+        writeJsonHistogram(out, wait[c]);
+        sep = ",";
+    }
+    out << "\n  },\n  \"frame\": ";
+    writeJsonHistogram(out, frame);
+    out << ",\n  \"search\": ";
+    writeJsonHistogram(out, searchLatency);
+    out << ",\n  \"searches\": " << searches.load(std::memory_order_relaxed)
+        << ",\n  \"nodes\": " << nodes.load(std::memory_order_relaxed)
+        << ",\n  \"timeouts\": " << timeouts.load(std::memory_order_relaxed)
+        << ",\n  \"recent_searches\": [";
+
+    std::vector<SearchTelemetry> rows;
+    for (const TelemetrySlot& slot : recent)
+    {
+        SearchTelemetry t;
+        if (readSlot(slot, t))
+            rows.push_back(t);
+    }
+    std::sort(rows.begin(), rows.end(),
+              [](const SearchTelemetry& a, const SearchTelemetry& b) { return a.sequence < b.sequence; });
+    sep = "";
+    for (const SearchTelemetry& t : rows)
+    {
+        out << sep << "\n    {\"seq\": " << t.sequence << ", \"latency_us\": " << t.latencyUs
+            << ", \"depth\": " << t.depth << ", \"seldepth\": " << t.seldepth << ", \"nodes\": " << t.nodes
+            << ", \"nps\": " << t.nps << ", \"hashfull\": " << t.hashfull << ", \"tbhits\": " << t.tbhits
+            << ", \"time_ms\": " << t.timeMs << ", \"score\": \"" << (t.mate ? "mate " : "cp ") << t.score << "\"}";
+        sep = ",";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// Output: the process-wide metrics
+Metrics& metrics()
+{
+    static Metrics instance;
+    return instance;
+}
+
+// Input: output path without extension, flush interval
+MetricsExporter::MetricsExporter(std::string basePath, std::chrono::milliseconds interval)
+    : basePath(std::move(basePath)), interval(interval)
+{
+    worker = std::thread([this]
+    {
+        const auto slice = std::chrono::milliseconds(50);
+        auto next = std::chrono::steady_clock::now() + this->interval;
+        while (!stopping.load(std::memory_order_relaxed))
+        {
+            std::this_thread::sleep_for(slice);
+            if (std::chrono::steady_clock::now() < next)
+                continue;
+            flush();
+            next += this->interval;
+        }
+    });
+}
+
+// Writes a last snapshot and stops the thread
+MetricsExporter::~MetricsExporter()
+{
+    stopping.store(true, std::memory_order_relaxed);
+    worker.join();
+    flush();
+}
+
+// Writes both files now, replacing them atomically so a scraper never sees half a file
+// Input: None
+// Output: false if a file could not be written
+bool MetricsExporter::flush() const
+{
+    bool ok = replaceFile(basePath + ".prom", [](std::ostream& out) { metrics().writePrometheus(out); });
+    return replaceFile(basePath + ".json", [](std::ostream& out) { metrics().writeJson(out); }) && ok;
+}
@@ -0,0 +1,165 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Lock-free latency histograms and search telemetry, exported as Prometheus text and JSON
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+struct SearchResult;
+
+// UCI commands are timed separately so a slow "go" is not hidden among cheap "isready"s
+enum class UciCommand : std::uint8_t { Uci, IsReady, SetOption, NewGame, Position, Go, Stop, PonderHit, Quit, Other, Count };
+
+// Input: command line as sent to the engine
+// Output: its type, by the first word
+UciCommand classifyCommand(std::string_view cmd);
+
+// Input: command type
+// Output: lowercase label used in the exported metrics
+const char* commandName(UciCommand command);
+
+// Log-bucketed histogram of nanosecond durations: 8 buckets per power of two (at most 12.5%
+// error) from 1 ns to centuries. Recording is two relaxed atomic adds and never blocks.
+class LatencyHistogram
+{
+public:
+    static constexpr int SubBits = 3;
+    static constexpr int SubBuckets = 1 << SubBits;
+    static constexpr int Buckets = (64 - SubBits + 1) * SubBuckets;
+
+    // Input: duration in nanoseconds
+    // Output: None
+    void record(std::uint64_t ns);
+
+    void record(std::chrono::steady_clock::duration d)
+    {
+        record(std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()));
+    }
+
+    std::uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    std::uint64_t sumNs() const { return sum.load(std::memory_order_relaxed); }
+    std::uint64_t maxNs() const { return largest.load(std::memory_order_relaxed); }
+
+    // Input: fraction in [0, 1]
+    // Output: upper edge of the bucket holding that quantile, in ns (0 if empty)
+    std::uint64_t percentile(double p) const;
+
+    // Input: upper edge in ns
+    // Output: number of samples below it (exact when it is a power of two)
+    std::uint64_t countBelow(std::uint64_t ns) const;
+
+    // Input: bucket index
+    // Output: smallest value falling into it
+    static std::uint64_t bucketLow(int index);
+
+    // Input: value in ns
+    // Output: bucket index
+    static int bucketOf(std::uint64_t ns);
+
+private:
+    std::array<std::atomic<std::uint64_t>, Buckets> counts{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> largest{0};
+};
+
+// One finished engine search, as reported by its last info line
+struct SearchTelemetry
+{
+    std::uint64_t sequence = 0;     // 1 for the first search recorded
+    std::uint64_t latencyUs = 0;    // wall time from "go" to "bestmove"
+    std::uint64_t nodes = 0;
+    std::uint64_t nps = 0;
+    std::uint64_t tbhits = 0;
+    int depth = 0;
+    int seldepth = 0;
+    int hashfull = 0;
+    int timeMs = 0;
+    int score = 0;
+    bool mate = false;
+};
+
+// Process-wide metrics; every member may be updated from any thread without locks
+class Metrics
+{
+public:
+    static constexpr std::size_t RecentSearches = 64;
+
+    // time spent writing each command type to the engine
+    std::array<LatencyHistogram, std::size_t(UciCommand::Count)> send;
+    // time spent waiting for the engine's answer, by the command that asked for it
+    std::array<LatencyHistogram, std::size_t(UciCommand::Count)> wait;
+    // displayBoard calls that presented a frame
+    LatencyHistogram frame;
+
+    // per-search distributions from the engine's info lines
+    LatencyHistogram searchLatency;
+    std::atomic<std::uint64_t> searches{0};
+    std::atomic<std::uint64_t> nodes{0};
+    std::atomic<std::uint64_t> timeouts{0};
+
+    // Keeps the final info of a search for the recent-moves table and the totals
+    // Input: finished search, wall time it took
+    // Output: None
+    void recordSearch(const SearchResult& result, std::chrono::steady_clock::duration latency);
+
+    // Input: stream
+    // Output: None (writes the Prometheus text exposition format)
+    void writePrometheus(std::ostream& out) const;
+
+    // Input: stream
+    // Output: None (writes the same data plus recent searches as JSON)
+    void writeJson(std::ostream& out) const;
+
+private:
+    // A seqlock per slot: writers claim slots round-robin, readers retry a slot that changed
+    struct TelemetrySlot
+    {
+        std::atomic<std::uint64_t> version{0};
+        std::array<std::atomic<std::uint64_t>, 11> fields{};
+    };
+
+    bool readSlot(const TelemetrySlot& slot, SearchTelemetry& out) const;
+
+    std::array<TelemetrySlot, RecentSearches> recent;
+};
+
+// Output: the process-wide metrics
+Metrics& metrics();
+
+// Rewrites <base>.prom and <base>.json every interval from a background thread
+class MetricsExporter
+{
+public:
+    // Input: output path without extension, flush interval
+    MetricsExporter(std::string basePath, std::chrono::milliseconds interval);
+
+    // Writes a last snapshot and stops the thread
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Writes both files now, replacing them atomically so a scraper never sees half a file
+    // Input: None
+    // Output: false if a file could not be written
+    bool flush() const;
+
+private:
+    std::string basePath;
+    std::chrono::milliseconds interval;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
@@ -0,0 +1,79 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: chess_perft - counts move generator leaf nodes for the regression tests, without SFML
+*/
+
+#include "position.h"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    // Prints per-move perft counts in the same format as Stockfish's "go perft"
+    // Input: position, depth
+    // Output: None (prints to stdout)
+    void printPerft(const Position& pos, int depth)
+    {
+        MoveList list;
+        pos.legalMoves(list);
+
+        std::uint64_t total = 0;
+        for (Move m : list)
+        {
+            Position next = pos;
+            next.doMove(m);
+            std::uint64_t n = depth > 1 ? next.perft(depth - 1) : 1;
+            total += n;
+            std::cout << Position::toUci(m) << ": " << n << "\n";
+        }
+        std::cout << "\nNodes searched: " << total << "\n";
+    }
+}
+
+// chess_perft --depth d [--fen fen]
+int main(int argc, char* argv[])
+{
+    int depth = 0;
+    std::string fen = Position::StartFen;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try
+        {
+            if (arg == "--depth" && hasValue) depth = std::stoi(argv[++i]);
+            else if (arg == "--fen" && hasValue) fen = argv[++i];
+            else
+            {
+                std::cerr << "Unknown argument: " << arg << "\n";
+                return 1;
+            }
+        }
+        catch (const std::logic_error&)
+        {
+            // std::stoi throws invalid_argument or out_of_range
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    if (depth <= 0)
+    {
+        std::cerr << "Usage: chess_perft --depth d [--fen fen]\n";
+        return 1;
+    }
+
+    Position pos;
+    if (!pos.setFen(fen))
+    {
+        std::cerr << "Invalid FEN: " << fen << "\n";
+        return 1;
+    }
+    printPerft(pos, depth);
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Streaming PGN reader that replays games through the move generator
+*/
+
+#include "pgn.h"
+
+#include <cctype>
+
+namespace
+{
+    bool isResult(const std::string& token)
+    {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+
+    int pieceFromLetter(char c)
+    {
+        switch (c)
+        {
+            case 'N': return Knight;
+            case 'B': return Bishop;
+            case 'R': return Rook;
+            case 'Q': return Queen;
+            case 'K': return King;
+            default:  return NoPieceType;
+        }
+    }
+}
+
+// Input: position, move in standard algebraic notation such as "Nbd7", "exd8=Q+" or "O-O"
+// Output: the matching legal move, or NoMove
+Move parseSan(const Position& pos, const std::string& san)
+{
+    std::string s;
+    for (char c : san)
+        if (c != '+' && c != '#' && c != '!' && c != '?' && c != 'x' && c != '=')
+            s += c;
+
+    MoveList list;
+    pos.legalMoves(list);
+
+    // castling is the king's two-square move
+    if (s == "O-O" || s == "0-0" || s == "O-O-O" || s == "0-0-0")
+    {
+        bool kingside = s.size() == 3;
+        for (Move m : list)
+            if (typeOf(pos.pieceOn(fromSq(m))) == King && toSq(m) - fromSq(m) == (kingside ? 2 : -2))
+                return m;
+        return NoMove;
+    }
+
+    PieceType piece = Pawn;
+    if (!s.empty() && pieceFromLetter(s[0]) != NoPieceType)
+    {
+        piece = PieceType(pieceFromLetter(s[0]));
+        s.erase(0, 1);
+    }
+
+    PieceType promo = NoPieceType;
+    if (!s.empty() && pieceFromLetter(s.back()) != NoPieceType)
+    {
+        promo = PieceType(pieceFromLetter(s.back()));
+        s.pop_back();
+    }
+
+    if (s.size() < 2)
+        return NoMove;
+    Square to = makeSquare(s[s.size() - 2] - 'a', s[s.size() - 1] - '1');
+
+    // whatever remains before the destination disambiguates the origin
+    int fromFile = -1;
+    int fromRank = -1;
+    for (std::size_t i = 0; i + 2 < s.size(); i++)
+    {
+        if (s[i] >= 'a' && s[i] <= 'h') fromFile = s[i] - 'a';
+        else if (s[i] >= '1' && s[i] <= '8') fromRank = s[i] - '1';
+    }
+
+    for (Move m : list)
+    {
+        Square from = fromSq(m);
+        if (toSq(m) == to && typeOf(pos.pieceOn(from)) == piece && promotionOf(m) == promo
+            && (fromFile < 0 || fileOf(from) == fromFile) && (fromRank < 0 || rankOf(from) == fromRank))
+            return m;
+    }
+    return NoMove;
+}
+
+// Reads the next game's main line, skipping comments, variations and NAGs
+// Input: strings to receive the starting FEN and the SAN moves
+// Output: false at end of input
+bool PgnReader::nextGame(std::string& startFen, std::vector<std::string>& sanMoves)
+{
+    startFen = Position::StartFen;
+    sanMoves.clear();
+
+    bool started = false;
+    bool inComment = false;
+    int variationDepth = 0;
+    std::string line;
+
+    while (std::getline(in, line))
+    {
+        if (!inComment && variationDepth == 0 && !line.empty() && line[0] == '[')
+        {
+            const std::string fenTag = "[FEN \"";
+            if (line.compare(0, fenTag.size(), fenTag) == 0)
+                startFen = line.substr(fenTag.size(), line.rfind('"') - fenTag.size());
+            started = true;
+            continue;
+        }
+        if (!line.empty() && line[0] == '%')
+            continue;
+
+        // returns true once the game's result token is reached
+        std::string token;
+        auto flush = [&]()
+        {
+            if (token.empty() || variationDepth > 0)
+            {
+                token.clear();
+                return false;
+            }
+
+            // "12." and "12...e5" both carry a move number prefix
+            std::size_t dot = token.find_last_of('.');
+            if (dot != std::string::npos)
+                token.erase(0, dot + 1);
+
+            if (isResult(token))
+                return true;
+            if (!token.empty() && token[0] != '$')
+            {
+                sanMoves.push_back(token);
+                started = true;
+            }
+            token.clear();
+            return false;
+        };
+
+        line += ' ';
+        for (char c : line)
+        {
+            if (inComment)
+            {
+                inComment = c != '}';
+                continue;
+            }
+
+            bool separator = c == '{' || c == ';' || c == '(' || c == ')' || std::isspace(static_cast<unsigned char>(c));
+            if (!separator)
+            {
+                token += c;
+                continue;
+            }
+            if (flush())
+                return true;
+
+            if (c == '{') inComment = true;
+            else if (c == ';') break;
+            else if (c == '(') variationDepth++;
+            else if (c == ')') variationDepth--;
+        }
+    }
+
+    return started;
+}
@@ -0,0 +1,33 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Streaming PGN reader that replays games through the move generator
+*/
+
+#pragma once
+
+#include "position.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+// Input: position, move in standard algebraic notation such as "Nbd7", "exd8=Q+" or "O-O"
+// Output: the matching legal move, or NoMove
+Move parseSan(const Position& pos, const std::string& san);
+
+// Reads one game at a time from a PGN stream
+class PgnReader
+{
+public:
+    explicit PgnReader(std::istream& in) : in(in) {}
+
+    // Reads the next game's main line, skipping comments, variations and NAGs
+    // Input: strings to receive the starting FEN and the SAN moves
+    // Output: false at end of input
+    bool nextGame(std::string& startFen, std::vector<std::string>& sanMoves);
+
+private:
+    std::istream& in;
+};
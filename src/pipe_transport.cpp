@@ -0,0 +1,182 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Byte transport to a Stockfish child process over pipes
+*/
+
+#include "engine_transport.h"
+#include "uci_engine.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    // Formats errno into a UciError message
+    // Input: const char* what
+    // Output: UciError
+    UciError sysError(const char* what)
+    {
+        return UciError(std::string(what) + ": " + std::strerror(errno));
+    }
+}
+
+// Forks and execs the engine binary at path
+// Input: std::string path to executable
+// Output: None (throws UciError on failure)
+PipeTransport::PipeTransport(const std::string& path)
+{
+    // a dead engine must surface as EPIPE, not kill us
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // close-on-exec from the start, so an engine forked concurrently on another thread never
+    // inherits these ends; the child's dup2 onto stdin/stdout clears the flag on the copies it keeps
+    int toEngine[2];
+    int fromEngine[2];
+    if (pipe2(toEngine, O_CLOEXEC) < 0)
+        throw sysError("pipe");
+    if (pipe2(fromEngine, O_CLOEXEC) < 0)
+    {
+        ::close(toEngine[0]);
+        ::close(toEngine[1]);
+        throw sysError("pipe");
+    }
+
+    pid_t child = fork();
+    if (child < 0)
+    {
+        ::close(toEngine[0]); ::close(toEngine[1]);
+        ::close(fromEngine[0]); ::close(fromEngine[1]);
+        throw sysError("fork");
+    }
+
+    if (child == 0)
+    {
+        dup2(toEngine[0], STDIN_FILENO);
+        dup2(fromEngine[1], STDOUT_FILENO);
+        ::close(toEngine[0]); ::close(toEngine[1]);
+        ::close(fromEngine[0]); ::close(fromEngine[1]);
+
+        execlp(path.c_str(), "stockfish", nullptr);
+        perror("execlp failed");
+        _exit(1);
+    }
+
+    // close unused pipe ends
+    ::close(toEngine[0]);
+    ::close(fromEngine[1]);
+
+    pid = child;
+    toFd = toEngine[1];
+    fromFd = fromEngine[0];
+    fcntl(fromFd, F_SETFL, fcntl(fromFd, F_GETFL) | O_NONBLOCK);
+}
+
+PipeTransport::~PipeTransport()
+{
+    close();
+}
+
+// Writes all bytes, retrying partial writes
+// Input: bytes, length
+// Output: None (throws UciError if the pipe is broken)
+void PipeTransport::write(const char* data, std::size_t len)
+{
+    if (toFd < 0)
+        throw UciError("engine is not running");
+
+    while (len > 0)
+    {
+        ssize_t n = ::write(toFd, data, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw sysError("write to engine");
+        }
+        data += n;
+        len -= static_cast<std::size_t>(n);
+    }
+}
+
+// Polls the pipe until output arrives or the deadline passes
+// Input: destination buffer, its size, deadline
+// Output: bytes read, 0 on timeout (throws UciError on EOF)
+std::size_t PipeTransport::read(char* out, std::size_t cap, std::chrono::steady_clock::time_point deadline)
+{
+    using Clock = std::chrono::steady_clock;
+
+    if (fromFd < 0)
+        throw UciError("engine is not running");
+
+    while (true)
+    {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+        if (remaining.count() <= 0)
+            return 0;
+
+        pollfd pfd{fromFd, POLLIN, 0};
+        int r = ::poll(&pfd, 1, static_cast<int>(remaining.count()));
+        if (r < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw sysError("poll");
+        }
+        if (r == 0)
+            continue;
+
+        ssize_t n = ::read(fromFd, out, cap);
+        if (n < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+            throw sysError("read from engine");
+        }
+        if (n == 0)
+            throw UciError("engine closed its output");
+        return static_cast<std::size_t>(n);
+    }
+}
+
+// Sends quit, closes the pipes and reaps the child
+// Input: None
+// Output: None
+void PipeTransport::close()
+{
+    if (pid <= 0)
+        return;
+
+    if (toFd >= 0)
+    {
+        static const char quit[] = "quit\n";
+        ssize_t ignored = ::write(toFd, quit, sizeof(quit) - 1);
+        (void)ignored;
+    }
+
+    if (toFd >= 0) ::close(toFd);
+    if (fromFd >= 0) ::close(fromFd);
+    toFd = fromFd = -1;
+
+    // give the engine a moment to exit on its own before killing it
+    int status = 0;
+    for (int i = 0; i < 50; i++)
+    {
+        if (waitpid(pid, &status, WNOHANG) != 0)
+        {
+            pid = -1;
+            return;
+        }
+        usleep(10000);
+    }
+
+    kill(pid, SIGKILL);
+    waitpid(pid, &status, 0);
+    pid = -1;
+}
@@ -0,0 +1,460 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Bitboard chess position with a fully legal move generator
+*/
+
+#include "position.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+namespace
+{
+    const char PieceLetters[] = " PNBRQK";
+
+    // Castling rights lost when a move starts or ends on the square
+    constexpr int castlingLost(Square s)
+    {
+        switch (s)
+        {
+            case 0:  return WhiteOOO;
+            case 4:  return WhiteOO | WhiteOOO;
+            case 7:  return WhiteOO;
+            case 56: return BlackOOO;
+            case 60: return BlackOO | BlackOOO;
+            case 63: return BlackOO;
+            default: return 0;
+        }
+    }
+
+    struct ZobristKeys
+    {
+        std::uint64_t psq[16][64];
+        std::uint64_t castling[16];
+        std::uint64_t epFile[8];
+        std::uint64_t side;
+    };
+
+    // Fixed-seed xorshift64* so hashes are stable across builds and runs
+    constexpr ZobristKeys makeZobristKeys()
+    {
+        ZobristKeys k{};
+        std::uint64_t s = 1070372;
+        auto next = [&s]()
+        {
+            s ^= s >> 12;
+            s ^= s << 25;
+            s ^= s >> 27;
+            return s * 2685821657736338717ULL;
+        };
+
+        for (auto& piece : k.psq)
+            for (auto& key : piece)
+                key = next();
+        for (auto& key : k.castling)
+            key = next();
+        for (auto& key : k.epFile)
+            key = next();
+        k.side = next();
+        return k;
+    }
+
+    constexpr ZobristKeys Zobrist = makeZobristKeys();
+}
+
+// Loads a position from FEN
+// Input: FEN string
+// Output: false if the placement field is malformed
+bool Position::setFen(const std::string& fen)
+{
+    for (Bitboard& b : byType) b = 0;
+    for (Bitboard& b : byColor) b = 0;
+    for (Piece& p : board) p = NoPiece;
+    castling = 0;
+    ep = NoSquare;
+    halfmove = 0;
+    fullmove = 1;
+    zobrist = 0;
+
+    std::stringstream ss(fen);
+    std::string placement, color, rights, epField;
+    ss >> placement >> color >> rights >> epField >> halfmove >> fullmove;
+
+    int file = 0;
+    int rank = 7;
+    for (char c : placement)
+    {
+        if (c == '/')
+        {
+            file = 0;
+            rank--;
+        }
+        else if (c >= '1' && c <= '8')
+            file += c - '0';
+        else
+        {
+            const char* p = nullptr;
+            for (int pt = Pawn; pt <= King; pt++)
+                if (PieceLetters[pt] == std::toupper(c))
+                    p = &PieceLetters[pt];
+            if (!p || file > 7 || rank < 0)
+                return false;
+            Color pc = std::isupper(c) ? White : Black;
+            putPiece(makePiece(pc, PieceType(p - PieceLetters)), makeSquare(file, rank));
+            file++;
+        }
+    }
+
+    if (popcount(pieces(White, King)) != 1 || popcount(pieces(Black, King)) != 1)
+        return false;
+
+    side = color == "b" ? Black : White;
+
+    for (char c : rights)
+    {
+        if (c == 'K') castling |= WhiteOO;
+        else if (c == 'Q') castling |= WhiteOOO;
+        else if (c == 'k') castling |= BlackOO;
+        else if (c == 'q') castling |= BlackOOO;
+    }
+
+    // keep the en-passant square only when a pawn can actually take there
+    if (epField.size() == 2 && epField[0] >= 'a' && epField[0] <= 'h' && (epField[1] == '3' || epField[1] == '6'))
+    {
+        Square s = makeSquare(epField[0] - 'a', epField[1] - '1');
+        if (PawnAttacks[Color(!side)][s] & pieces(side, Pawn))
+            ep = s;
+    }
+
+    if (fullmove < 1)
+        fullmove = 1;
+
+    if (side == Black)
+        zobrist ^= Zobrist.side;
+    zobrist ^= Zobrist.castling[castling];
+    if (ep != NoSquare)
+        zobrist ^= Zobrist.epFile[fileOf(ep)];
+
+    return true;
+}
+
+// Input: None
+// Output: FEN string for the current position
+std::string Position::fen() const
+{
+    std::string s;
+    for (int rank = 7; rank >= 0; rank--)
+    {
+        int empty = 0;
+        for (int file = 0; file < 8; file++)
+        {
+            char c = pieceChar(makeSquare(file, rank));
+            if (c == ' ')
+            {
+                empty++;
+                continue;
+            }
+            if (empty)
+                s += char('0' + empty);
+            empty = 0;
+            s += c;
+        }
+        if (empty)
+            s += char('0' + empty);
+        if (rank > 0)
+            s += '/';
+    }
+
+    s += side == White ? " w " : " b ";
+    if (castling & WhiteOO) s += 'K';
+    if (castling & WhiteOOO) s += 'Q';
+    if (castling & BlackOO) s += 'k';
+    if (castling & BlackOOO) s += 'q';
+    if (!castling) s += '-';
+
+    if (ep == NoSquare)
+        s += " -";
+    else
+    {
+        s += ' ';
+        s += char('a' + fileOf(ep));
+        s += char('1' + rankOf(ep));
+    }
+
+    s += " " + std::to_string(halfmove) + " " + std::to_string(fullmove);
+    return s;
+}
+
+// Input: square
+// Output: FEN letter of the piece there, or ' ' if empty
+char Position::pieceChar(Square s) const
+{
+    Piece p = board[s];
+    if (p == NoPiece)
+        return ' ';
+    char c = PieceLetters[typeOf(p)];
+    return colorOf(p) == White ? c : char(std::tolower(c));
+}
+
+void Position::putPiece(Piece p, Square s)
+{
+    board[s] = p;
+    byType[typeOf(p)] |= squareBB(s);
+    byColor[colorOf(p)] |= squareBB(s);
+    zobrist ^= Zobrist.psq[p][s];
+}
+
+void Position::removePiece(Square s)
+{
+    Piece p = board[s];
+    board[s] = NoPiece;
+    byType[typeOf(p)] &= ~squareBB(s);
+    byColor[colorOf(p)] &= ~squareBB(s);
+    zobrist ^= Zobrist.psq[p][s];
+}
+
+// Input: square, occupancy to use for sliders
+// Output: pieces of both colors attacking the square
+Bitboard Position::attackersTo(Square s, Bitboard occ) const
+{
+    return (PawnAttacks[White][s] & pieces(Black, Pawn))
+         | (PawnAttacks[Black][s] & pieces(White, Pawn))
+         | (KnightAttacks[s] & byType[Knight])
+         | (rookAttacks(s, occ) & (byType[Rook] | byType[Queen]))
+         | (bishopAttacks(s, occ) & (byType[Bishop] | byType[Queen]))
+         | (KingAttacks[s] & byType[King]);
+}
+
+// Generates every legal move for the side to move
+// Input: list to fill
+// Output: list holds the legal moves
+void Position::legalMoves(MoveList& list) const
+{
+    const Color us = side;
+    const Color them = Color(!side);
+    const Bitboard occ = occupied();
+    const Bitboard own = pieces(us);
+    const Bitboard enemy = pieces(them);
+    const Square ksq = kingSquare(us);
+    const Bitboard checkers = attackersTo(ksq, occ) & enemy;
+
+    // the king must not hide behind itself from a slider, so test without it
+    Bitboard kingTargets = KingAttacks[ksq] & ~own;
+    while (kingTargets)
+    {
+        Square to = popLsb(kingTargets);
+        if (!(attackersTo(to, occ ^ squareBB(ksq)) & enemy))
+            list.add(makeMove(ksq, to));
+    }
+
+    // in double check only the king can move
+    if (popcount(checkers) > 1)
+        return;
+
+    const Bitboard target = checkers ? betweenBB(ksq, lsb(checkers)) | checkers : ~own;
+
+    // a piece is pinned when it is the only blocker between our king and an enemy slider
+    Bitboard pinned = 0;
+    Bitboard snipers = (rookAttacks(ksq, 0) & (pieces(them, Rook) | pieces(them, Queen)))
+                     | (bishopAttacks(ksq, 0) & (pieces(them, Bishop) | pieces(them, Queen)));
+    while (snipers)
+    {
+        Bitboard blockers = betweenBB(ksq, popLsb(snipers)) & occ;
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & own))
+            pinned |= blockers;
+    }
+
+    auto addTargets = [&](Square from, Bitboard to)
+    {
+        if (pinned & squareBB(from))
+            to &= lineBB(ksq, from);
+        while (to)
+            list.add(makeMove(from, popLsb(to)));
+    };
+
+    for (Bitboard b = pieces(us, Knight); b;)
+    {
+        Square from = popLsb(b);
+        addTargets(from, KnightAttacks[from] & target);
+    }
+    for (Bitboard b = pieces(us, Bishop); b;)
+    {
+        Square from = popLsb(b);
+        addTargets(from, bishopAttacks(from, occ) & target);
+    }
+    for (Bitboard b = pieces(us, Rook); b;)
+    {
+        Square from = popLsb(b);
+        addTargets(from, rookAttacks(from, occ) & target);
+    }
+    for (Bitboard b = pieces(us, Queen); b;)
+    {
+        Square from = popLsb(b);
+        addTargets(from, queenAttacks(from, occ) & target);
+    }
+
+    const int up = us == White ? 8 : -8;
+    const Bitboard doublePushRank = us == White ? Rank1BB << 16 : Rank1BB << 40;
+    const Bitboard promotionRank = us == White ? Rank8BB : Rank1BB;
+
+    for (Bitboard b = pieces(us, Pawn); b;)
+    {
+        Square from = popLsb(b);
+        Square one = from + up;
+
+        Bitboard to = PawnAttacks[us][from] & enemy;
+        if (!(occ & squareBB(one)))
+        {
+            to |= squareBB(one);
+            if ((squareBB(one) & doublePushRank) && !(occ & squareBB(one + up)))
+                to |= squareBB(one + up);
+        }
+
+        to &= target;
+        if (pinned & squareBB(from))
+            to &= lineBB(ksq, from);
+
+        while (to)
+        {
+            Square t = popLsb(to);
+            if (squareBB(t) & promotionRank)
+            {
+                list.add(makeMove(from, t, Queen));
+                list.add(makeMove(from, t, Rook));
+                list.add(makeMove(from, t, Bishop));
+                list.add(makeMove(from, t, Knight));
+            }
+            else
+                list.add(makeMove(from, t));
+        }
+
+        // en passant removes two pieces from one rank, so check the resulting position directly
+        if (ep != NoSquare && (PawnAttacks[us][from] & squareBB(ep)))
+        {
+            Square capsq = ep - up;
+            Bitboard after = (occ ^ squareBB(from) ^ squareBB(capsq)) | squareBB(ep);
+            if (!(attackersTo(ksq, after) & enemy & ~squareBB(capsq)))
+                list.add(makeMove(from, ep));
+        }
+    }
+
+    if (checkers)
+        return;
+
+    auto safe = [&](Square s) { return !(attackersTo(s, occ) & enemy); };
+    const Square base = us == White ? 0 : 56;
+    const Piece rook = makePiece(us, Rook);
+
+    if ((castling & (us == White ? WhiteOO : BlackOO)) && board[base + 7] == rook
+        && !(occ & (squareBB(base + 5) | squareBB(base + 6))) && safe(base + 5) && safe(base + 6))
+        list.add(makeMove(ksq, base + 6));
+
+    if ((castling & (us == White ? WhiteOOO : BlackOOO)) && board[base] == rook
+        && !(occ & (squareBB(base + 1) | squareBB(base + 2) | squareBB(base + 3))) && safe(base + 3) && safe(base + 2))
+        list.add(makeMove(ksq, base + 2));
+}
+
+// Input: move in UCI notation such as "e7e8q"
+// Output: the matching legal move, or NoMove
+Move Position::parseUci(const std::string& uci) const
+{
+    MoveList list;
+    legalMoves(list);
+    for (Move m : list)
+        if (toUci(m) == uci)
+            return m;
+    return NoMove;
+}
+
+// Input: move
+// Output: UCI string such as "e1g1" or "a7a8q"
+std::string Position::toUci(Move m)
+{
+    std::string s;
+    s += char('a' + fileOf(fromSq(m)));
+    s += char('1' + rankOf(fromSq(m)));
+    s += char('a' + fileOf(toSq(m)));
+    s += char('1' + rankOf(toSq(m)));
+    if (promotionOf(m) != NoPieceType)
+        s += char(std::tolower(PieceLetters[promotionOf(m)]));
+    return s;
+}
+
+// Plays a legal move
+// Input: move from legalMoves
+// Output: None
+void Position::doMove(Move m)
+{
+    const Color us = side;
+    const Color them = Color(!side);
+    const Square from = fromSq(m);
+    const Square to = toSq(m);
+    const Piece pc = board[from];
+    const PieceType pt = typeOf(pc);
+
+    Square capsq = to;
+    if (pt == Pawn && to == ep)
+        capsq = to + (us == White ? -8 : 8);
+    const bool capture = board[capsq] != NoPiece;
+    if (capture)
+        removePiece(capsq);
+
+    removePiece(from);
+    putPiece(promotionOf(m) != NoPieceType ? makePiece(us, promotionOf(m)) : pc, to);
+
+    if (pt == King && std::abs(to - from) == 2)
+    {
+        Square rookFrom = to > from ? to + 1 : to - 2;
+        Square rookTo = to > from ? to - 1 : to + 1;
+        Piece rook = board[rookFrom];
+        removePiece(rookFrom);
+        putPiece(rook, rookTo);
+    }
+
+    zobrist ^= Zobrist.castling[castling];
+    castling &= ~(castlingLost(from) | castlingLost(to));
+    zobrist ^= Zobrist.castling[castling];
+
+    if (ep != NoSquare)
+        zobrist ^= Zobrist.epFile[fileOf(ep)];
+    ep = NoSquare;
+    if (pt == Pawn && std::abs(to - from) == 16)
+    {
+        Square passed = (from + to) / 2;
+        if (PawnAttacks[us][passed] & pieces(them, Pawn))
+        {
+            ep = passed;
+            zobrist ^= Zobrist.epFile[fileOf(ep)];
+        }
+    }
+
+    halfmove = (capture || pt == Pawn) ? 0 : halfmove + 1;
+    if (us == Black)
+        fullmove++;
+
+    side = them;
+    zobrist ^= Zobrist.side;
+}
+
+// Counts leaf nodes of the legal move tree
+// Input: depth in plies
+// Output: number of leaves
+std::uint64_t Position::perft(int depth) const
+{
+    MoveList list;
+    legalMoves(list);
+    if (depth <= 1)
+        return depth == 1 ? std::uint64_t(list.size) : 1;
+
+    std::uint64_t nodes = 0;
+    for (Move m : list)
+    {
+        Position next = *this;
+        next.doMove(m);
+        nodes += next.perft(depth - 1);
+    }
+    return nodes;
+}
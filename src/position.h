@@ -0,0 +1,121 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Bitboard chess position with a fully legal move generator
+*/
+
+#pragma once
+
+#include "bitboard.h"
+
+#include <cstdint>
+#include <string>
+
+// from (6 bits) | to (6 bits) | promotion piece type (3 bits); castling is the king's two-square move
+using Move = std::uint16_t;
+constexpr Move NoMove = 0;
+
+constexpr Move makeMove(Square from, Square to, PieceType promo = NoPieceType)
+{
+    return Move(from | (to << 6) | (promo << 12));
+}
+constexpr Square fromSq(Move m) { return m & 63; }
+constexpr Square toSq(Move m) { return (m >> 6) & 63; }
+constexpr PieceType promotionOf(Move m) { return PieceType(m >> 12); }
+
+// Fixed-size list so move generation never allocates
+struct MoveList
+{
+    Move moves[256];
+    int size = 0;
+
+    void add(Move m) { moves[size++] = m; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + size; }
+};
+
+enum CastlingRight
+{
+    WhiteOO = 1,
+    WhiteOOO = 2,
+    BlackOO = 4,
+    BlackOOO = 8
+};
+
+class Position
+{
+public:
+    static constexpr const char* StartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    Position() { setFen(StartFen); }
+
+    // Loads a position from FEN
+    // Input: FEN string
+    // Output: false if the placement field is malformed
+    bool setFen(const std::string& fen);
+
+    // Input: None
+    // Output: FEN string for the current position
+    std::string fen() const;
+
+    // Input: square
+    // Output: FEN letter of the piece there, or ' ' if empty
+    char pieceChar(Square s) const;
+
+    Color sideToMove() const { return side; }
+    Square epSquare() const { return ep; }
+    int castlingRights() const { return castling; }
+    Piece pieceOn(Square s) const { return board[s]; }
+    int halfmoveClock() const { return halfmove; }
+    int fullmoveNumber() const { return fullmove; }
+
+    // Zobrist hash, updated incrementally by doMove
+    std::uint64_t key() const { return zobrist; }
+
+    // Generates every legal move for the side to move
+    // Input: list to fill
+    // Output: list holds the legal moves
+    void legalMoves(MoveList& list) const;
+
+    // Input: move in UCI notation such as "e7e8q"
+    // Output: the matching legal move, or NoMove
+    Move parseUci(const std::string& uci) const;
+
+    // Input: move
+    // Output: UCI string such as "e1g1" or "a7a8q"
+    static std::string toUci(Move m);
+
+    // Plays a legal move
+    // Input: move from legalMoves
+    // Output: None
+    void doMove(Move m);
+
+    // Counts leaf nodes of the legal move tree
+    // Input: depth in plies
+    // Output: number of leaves
+    std::uint64_t perft(int depth) const;
+
+private:
+    Bitboard pieces(Color c) const { return byColor[c]; }
+    Bitboard pieces(Color c, PieceType pt) const { return byColor[c] & byType[pt]; }
+    Bitboard occupied() const { return byColor[White] | byColor[Black]; }
+    Square kingSquare(Color c) const { return lsb(pieces(c, King)); }
+
+    // Input: square, occupancy to use for sliders
+    // Output: pieces of both colors attacking the square
+    Bitboard attackersTo(Square s, Bitboard occ) const;
+
+    void putPiece(Piece p, Square s);
+    void removePiece(Square s);
+
+    Bitboard byType[7] = {};
+    Bitboard byColor[2] = {};
+    Piece board[64] = {};
+    Color side = White;
+    int castling = 0;
+    Square ep = NoSquare;
+    int halfmove = 0;
+    int fullmove = 1;
+    std::uint64_t zobrist = 0;
+};
@@ -0,0 +1,191 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Batched SFML board renderer with a pre-rasterized piece atlas
+*/
+
+#include "renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    const sf::Color LightColor(200, 180, 140);
+    const sf::Color DarkColor(120, 80, 50);
+
+    // The atlas is a square grid of cells: 12 pieces, then a solid white block
+    const unsigned AtlasColumns = 4;
+    const unsigned SolidCell = 12;
+
+    // Maps board char to chess font char
+    // Input: char piece
+    // Output: char used in chess font
+    char mapPieceToFont(char piece)
+    {
+        switch(piece)
+        {
+            case 'B': return 'n'; case 'N': return 'j'; case 'K': return 'l';
+            case 'Q': return 'w'; case 'R': return 't'; case 'P': return 'o';
+            case 'b': return 'n'; case 'n': return 'j'; case 'k': return 'l';
+            case 'q': return 'w'; case 'r': return 't'; case 'p': return 'o';
+            case ' ': return ' ';
+            default: return ' ';
+        }
+    }
+
+    // Fills four vertices with a screen-space square mapped to a texture rectangle
+    void setQuad(sf::Vertex* quad, float x, float y, float size, const sf::FloatRect& tex, const sf::Color& color)
+    {
+        quad[0].position = sf::Vector2f(x, y);
+        quad[1].position = sf::Vector2f(x + size, y);
+        quad[2].position = sf::Vector2f(x + size, y + size);
+        quad[3].position = sf::Vector2f(x, y + size);
+
+        quad[0].texCoords = sf::Vector2f(tex.left, tex.top);
+        quad[1].texCoords = sf::Vector2f(tex.left + tex.width, tex.top);
+        quad[2].texCoords = sf::Vector2f(tex.left + tex.width, tex.top + tex.height);
+        quad[3].texCoords = sf::Vector2f(tex.left, tex.top + tex.height);
+
+        for (int i = 0; i < 4; i++)
+            quad[i].color = color;
+    }
+}
+
+// Rasterizes the piece glyphs into the atlas and builds the board squares
+// Input: tile size in pixels, chess font (only needed during construction)
+BoardRenderer::BoardRenderer(float tileSize, const sf::Font& font)
+    : tileSize(tileSize), vertices(sf::Quads, BoardVertices)
+{
+    // huge tiles get smaller cells rather than an atlas the GPU cannot hold; quads scale them up
+    const unsigned cell = std::min(unsigned(std::ceil(tileSize)), sf::Texture::getMaximumSize() / AtlasColumns);
+    atlasReady = cell > 0 && atlas.create(cell * AtlasColumns, cell * AtlasColumns);
+    if (!atlasReady)
+        std::cerr << "Failed to create the piece atlas; drawing the board without pieces\n";
+    atlas.clear(sf::Color::Transparent);
+    auto cellCorner = [&](unsigned index)
+    {
+        return sf::Vector2f(float(index % AtlasColumns * cell), float(index / AtlasColumns * cell));
+    };
+
+    const char letters[] = "PNBRQK";
+    for (int color = White; color <= Black; color++)
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            const sf::Vector2f corner = cellCorner(unsigned(color * 6 + i));
+
+            sf::Text piece;
+            piece.setFont(font);
+            piece.setString(std::string(1, mapPieceToFont(letters[i])));
+            piece.setCharacterSize(unsigned(cell * 0.9f));
+
+            sf::FloatRect b = piece.getLocalBounds();
+            piece.setOrigin(b.left + b.width/2, b.top + b.height/2);
+            piece.setPosition(corner.x + cell/2.f, corner.y + cell/2.f);
+            piece.setFillColor(color == White ? sf::Color::White : sf::Color::Black);
+            atlas.draw(piece);
+
+            glyphRects[makePiece(Color(color), PieceType(Pawn + i))] = sf::FloatRect(corner.x, corner.y, float(cell), float(cell));
+        }
+    }
+
+    const sf::Vector2f solidCorner = cellCorner(SolidCell);
+    sf::RectangleShape solid(sf::Vector2f(4.f, 4.f));
+    solid.setPosition(solidCorner.x, solidCorner.y);
+    solid.setFillColor(sf::Color::White);
+    atlas.draw(solid);
+    atlas.display();
+    const sf::Vector2f solidTexel(solidCorner.x + 2.f, solidCorner.y + 2.f);  // tints the board squares
+
+    // the squares never change, so they are laid out once at the front of the array
+    const sf::FloatRect solidRect(solidTexel.x, solidTexel.y, 0.f, 0.f);
+    for (int r = 0; r < 8; r++)
+        for (int c = 0; c < 8; c++)
+            setQuad(&vertices[(r * 8 + c) * 4], c * tileSize, r * tileSize, tileSize, solidRect,
+                    (r + c) % 2 == 0 ? LightColor : DarkColor);
+
+    // no real piece code, so the first setPosition always builds the piece quads
+    shown.fill(Piece(0xFF));
+}
+
+// Rebuilds the piece quads if any square changed
+// Input: position to show
+// Output: None
+void BoardRenderer::setPosition(const Position& pos)
+{
+    std::array<Piece, 64> next;
+    for (int r = 0; r < 8; r++)
+        for (int c = 0; c < 8; c++)
+            next[r * 8 + c] = pos.pieceOn(makeSquare(c, 7 - r));  // flip row for white at bottom
+
+    if (next == shown)
+        return;
+    shown = next;
+
+    vertices.resize(BoardVertices);
+    for (int i = 0; i < 64; i++)
+    {
+        if (shown[i] == NoPiece)
+            continue;
+
+        std::size_t first = vertices.getVertexCount();
+        vertices.resize(first + 4);
+        setQuad(&vertices[first], (i % 8) * tileSize, (i / 8) * tileSize, tileSize, glyphRects[shown[i]],
+                sf::Color::White);
+    }
+    dirty = true;
+}
+
+// Clears the target and draws the board with a single draw call
+// Input: render target
+// Output: None
+void BoardRenderer::draw(sf::RenderTarget& target) const
+{
+    target.clear();
+    if (atlasReady)
+        target.draw(vertices, sf::RenderStates(&atlas.getTexture()));
+    else
+        target.draw(&vertices[0], BoardVertices, sf::Quads);   // untextured squares keep their tint
+}
+
+// Draws and presents a frame only when something changed
+// Input: window
+// Output: true if a frame was drawn
+bool BoardRenderer::render(sf::RenderWindow& window)
+{
+    if (!dirty)
+        return false;
+
+    sf::Clock clock;
+    draw(window);
+    window.display();
+    float ms = clock.getElapsedTime().asMicroseconds() / 1000.f;
+
+    if (frameMs.size() < MaxFrameSamples)
+        frameMs.push_back(ms);
+    else
+        frameMs[frames % MaxFrameSamples] = ms;
+    frames++;
+    dirty = false;
+    return true;
+}
+
+// Prints frame count and frame-time percentiles
+// Input: stream
+// Output: None
+void BoardRenderer::printStats(std::ostream& out) const
+{
+    if (frames == 0)
+        return;
+
+    std::vector<float> sorted = frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    auto pct = [&](double p) { return sorted[std::size_t(p * (sorted.size() - 1))]; };
+
+    out << "Rendered " << frames << " frames: p50 " << pct(0.50) << " ms, p95 " << pct(0.95)
+        << " ms, max " << sorted.back() << " ms\n";
+}
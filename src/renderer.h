@@ -0,0 +1,63 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Batched SFML board renderer with a pre-rasterized piece atlas
+*/
+
+#pragma once
+
+#include "position.h"
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+// Draws the whole board and all pieces as one textured vertex array
+class BoardRenderer
+{
+public:
+    // Rasterizes the piece glyphs into the atlas and builds the board squares
+    // Input: tile size in pixels, chess font (only needed during construction)
+    BoardRenderer(float tileSize, const sf::Font& font);
+
+    // Rebuilds the piece quads if any square changed
+    // Input: position to show
+    // Output: None
+    void setPosition(const Position& pos);
+
+    // Forces the next render, e.g. after a resize or when the window regains focus
+    void invalidate() { dirty = true; }
+
+    // Clears the target and draws the board with a single draw call
+    // Input: render target
+    // Output: None
+    void draw(sf::RenderTarget& target) const;
+
+    // Draws and presents a frame only when something changed
+    // Input: window
+    // Output: true if a frame was drawn
+    bool render(sf::RenderWindow& window);
+
+    // Prints frame count and frame-time percentiles
+    // Input: stream
+    // Output: None
+    void printStats(std::ostream& out) const;
+
+private:
+    static constexpr std::size_t BoardVertices = 64 * 4;
+    static constexpr std::size_t MaxFrameSamples = 4096;
+
+    float tileSize;
+    sf::RenderTexture atlas;
+    bool atlasReady = false;                    // false if the GPU refused the atlas
+    std::array<sf::FloatRect, 16> glyphRects{}; // atlas cell per Piece code
+    std::array<Piece, 64> shown{};              // pieces currently in the vertex array
+    sf::VertexArray vertices;
+    bool dirty = true;
+
+    std::size_t frames = 0;
+    std::vector<float> frameMs;                 // ring of recent frame times
+};
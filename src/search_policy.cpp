@@ -0,0 +1,181 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Chooses how long the engine may think and sizes its Threads/Hash for this machine
+*/
+
+#include "search_policy.h"
+#include "analysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+    // Stockfish answers within a few ms of its own limit; give it that before sending stop
+    const int MinGraceMs = 50;
+
+    // Appends to a fixed-size ring
+    void pushSample(std::vector<double>& ring, std::size_t& next, std::size_t window, double value)
+    {
+        if (ring.size() < window)
+            ring.push_back(value);
+        else
+            ring[next] = value;
+        next = (next + 1) % window;
+    }
+
+    // Smooths a running estimate, taking the first sample as is
+    double smooth(double current, double sample)
+    {
+        return current == 0 ? sample : 0.7 * current + 0.3 * sample;
+    }
+}
+
+SearchPolicy::SearchPolicy(const SearchLimits& limits) : limits(limits)
+{
+    clocks = {limits.baseMs, limits.baseMs};
+}
+
+// Input: ring of samples
+// Output: 95th percentile, 0 if empty
+double SearchPolicy::p95(const std::vector<double>& samples)
+{
+    if (samples.empty())
+        return 0;
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[std::size_t(0.95 * (sorted.size() - 1) + 0.5)];
+}
+
+// Builds the next search for the engine
+// Input: side the engine plays
+// Output: go command, stop deadline and cache threshold
+SearchPlan SearchPolicy::plan(Color engineSide) const
+{
+    SearchPlan plan;
+    plan.cacheDepth = limits.depth;
+
+    if (limits.targetP95Ms > 0)
+    {
+        // leave room for what the engine's own clock does not see (I/O, bestmove flush, queues)
+        const double target = limits.targetP95Ms;
+        const double budget = std::max(target * 0.2, (target - p95(overheadMs)) * 0.9) * scale;
+
+        // deepest depth the measured speed and branching factor say fits in the budget
+        int depth = limits.depth;
+        if (nps > 0 && logBranching > 0)
+        {
+            while (depth > 1 && std::exp(logBranching * depth) / nps * 1000 > budget)
+                depth--;
+        }
+
+        const int budgetMs = std::max(1, int(budget));
+        plan.go = "go depth " + std::to_string(depth) + " movetime " + std::to_string(budgetMs);
+        plan.deadline = std::chrono::milliseconds(std::max(budgetMs + 1, int((budget + target) / 2)));
+        plan.cacheDepth = depth;
+    }
+    else if (limits.baseMs > 0)
+    {
+        // Stockfish budgets its own clock; the deadline only guards against a runaway search
+        const int own = clocks[engineSide];
+        plan.go = "go wtime " + std::to_string(clocks[White]) + " btime " + std::to_string(clocks[Black]) +
+                  " winc " + std::to_string(limits.incMs) + " binc " + std::to_string(limits.incMs);
+        const int allotted = own / 20 + limits.incMs;
+        plan.deadline = std::chrono::milliseconds(std::max(MinGraceMs, std::min(own - MinGraceMs, 3 * allotted)));
+    }
+    else if (limits.movetimeMs > 0)
+    {
+        plan.go = "go movetime " + std::to_string(limits.movetimeMs);
+        plan.deadline = std::chrono::milliseconds(limits.movetimeMs + std::max(MinGraceMs, limits.movetimeMs / 10));
+    }
+    else
+    {
+        // fixed depth: never stopped early, only the engine thread's hard timeout applies
+        plan.go = "go depth " + std::to_string(limits.depth);
+        plan.deadline = std::chrono::milliseconds(0);
+    }
+    return plan;
+}
+
+// Learns from a finished reply
+// Input: result, wall time the player waited, whether the engine actually searched
+// Output: None
+void SearchPolicy::observe(const SearchResult& result, std::chrono::microseconds latency, bool searched)
+{
+    const double ms = latency.count() / 1000.0;
+    pushSample(latencyMs, next, Window, ms);
+
+    if (searched)
+    {
+        if (result.timeMs > 0)
+            pushSample(overheadMs, nextOverhead, Window, std::max(0.0, ms - result.timeMs));
+        if (result.nps > 0)
+            nps = smooth(nps, double(result.nps));
+        if (result.depth >= 4 && result.nodes > 0)
+            logBranching = smooth(logBranching, std::log(double(result.nodes)) / result.depth);
+    }
+
+    // budgets follow the engine's own limits closely but not exactly; correct on the tail we see
+    if (limits.targetP95Ms > 0 && latencyMs.size() >= 8)
+    {
+        const double tail = p95(latencyMs);
+        if (tail > limits.targetP95Ms)
+            scale = std::max(0.1, scale * 0.85);
+        else if (tail < 0.7 * limits.targetP95Ms)
+            scale = std::min(1.0, scale * 1.05);
+    }
+}
+
+// Charges a side's clock for a move it made and adds the increment
+// Input: side, time it used
+// Output: None
+void SearchPolicy::charge(Color side, std::chrono::milliseconds used)
+{
+    if (!timed())
+        return;
+    clocks[side] = std::max(0, clocks[side] - int(used.count())) + limits.incMs;
+}
+
+// Input: None
+// Output: one line such as "depth 12" or "p95 target 250 ms"
+std::string SearchPolicy::describe() const
+{
+    if (limits.targetP95Ms > 0)
+        return "p95 target " + std::to_string(limits.targetP95Ms) + " ms, depth <= " + std::to_string(limits.depth);
+    if (limits.baseMs > 0)
+        return "clock " + std::to_string(limits.baseMs / 1000) + "+" + std::to_string(limits.incMs / 1000) + " s";
+    if (limits.movetimeMs > 0)
+        return "movetime " + std::to_string(limits.movetimeMs) + " ms";
+    return "depth " + std::to_string(limits.depth);
+}
+
+// Input: None
+// Output: engine threads for the interactive game: half the cores, at most 4. The engine plays
+// Skill-limited, ponders through the player's turn and shares the machine with the UI, so more
+// threads only cost responsiveness
+int recommendedThreads()
+{
+    return std::clamp(int(std::thread::hardware_concurrency()) / 2, 1, 4);
+}
+
+// Input: number of engines that will share the memory, largest size worth using
+// Output: per-engine hash size in MB: a quarter of free memory split between the engines,
+// rounded down to a power of two from 16 up to maxMB (4096 unless given)
+int recommendedHashMB(std::size_t engines, int maxMB)
+{
+    long pages = sysconf(_SC_AVPHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0)
+        return 16;
+
+    // a quarter of free memory, split between the engines
+    const double mb = double(pages) * double(pageSize) / 4 / double(std::max<std::size_t>(1, engines)) / (1 << 20);
+    int hash = 16;
+    while (hash * 2 <= mb && hash * 2 <= maxMB)
+        hash *= 2;
+    return hash;
+}
@@ -0,0 +1,96 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Chooses how long the engine may think and sizes its Threads/Hash for this machine
+*/
+
+#pragma once
+
+#include "bitboard.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct SearchResult;
+
+// What the user asked for; the first non-zero of targetP95Ms, baseMs, movetimeMs wins, else fixed depth
+struct SearchLimits
+{
+    int depth = 12;         // fixed depth, and the deepest the adaptive modes will go
+    int movetimeMs = 0;     // fixed time per move
+    int baseMs = 0;         // clock game: starting time per side
+    int incMs = 0;          // clock game: increment per move
+    int targetP95Ms = 0;    // adaptive: keep 95% of engine replies under this
+};
+
+// One search as the engine thread should run it
+struct SearchPlan
+{
+    std::string go = "go depth 12";         // the engine thread turns it into "go ponder ..." to ponder
+    std::chrono::milliseconds deadline{0};  // send stop this long after go/ponderhit (0: never)
+    int cacheDepth = 12;                    // cached results at least this deep are used instead
+};
+
+// Turns limits plus what earlier searches cost into the next go command
+class SearchPolicy
+{
+public:
+    explicit SearchPolicy(const SearchLimits& limits);
+
+    // Builds the next search for the engine
+    // Input: side the engine plays
+    // Output: go command, stop deadline and cache threshold
+    SearchPlan plan(Color engineSide) const;
+
+    // Learns from a finished reply
+    // Input: result, wall time the player waited, whether the engine actually searched
+    //        (false for cache hits and ponder hits, whose timings say nothing about speed)
+    // Output: None
+    void observe(const SearchResult& result, std::chrono::microseconds latency, bool searched);
+
+    // Charges a side's clock for a move it made and adds the increment
+    // Input: side, time it used
+    // Output: None
+    void charge(Color side, std::chrono::milliseconds used);
+
+    bool timed() const { return limits.baseMs > 0 && limits.targetP95Ms == 0; }
+    int clockMs(Color side) const { return clocks[side]; }
+
+    // Input: None
+    // Output: one line such as "depth 12" or "p95 target 250 ms"
+    std::string describe() const;
+
+private:
+    static constexpr std::size_t Window = 32;
+
+    // Input: ring of samples
+    // Output: 95th percentile, 0 if empty
+    static double p95(const std::vector<double>& samples);
+
+    SearchLimits limits;
+    std::array<int, 2> clocks{};
+
+    // adaptive mode state
+    std::vector<double> latencyMs;      // last Window replies, all kinds
+    std::vector<double> overheadMs;     // wall time minus engine-reported time
+    std::size_t next = 0;
+    std::size_t nextOverhead = 0;
+    double nps = 0;                     // smoothed nodes per second
+    double logBranching = 0;            // smoothed ln(nodes) / depth
+    double scale = 1;                   // shrinks while the p95 target is missed
+};
+
+// Input: None
+// Output: engine threads for the interactive game: half the cores, at most 4. The engine plays
+// Skill-limited, ponders through the player's turn and shares the machine with the UI, so more
+// threads only cost responsiveness
+int recommendedThreads();
+
+// Input: number of engines that will share the memory, largest size worth using
+// Output: per-engine hash size in MB: a quarter of free memory split between the engines,
+// rounded down to a power of two from 16 up to maxMB (4096 unless given)
+int recommendedHashMB(std::size_t engines, int maxMB = 4096);
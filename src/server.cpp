@@ -0,0 +1,759 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Headless TCP server that plays many games at once over a shared engine pool
+*/
+
+#include "server.h"
+#include "analysis.h"
+#include "analysis_cache.h"
+#include "console.h"
+#include "engine_pool.h"
+#include "game.h"
+#include "metrics.h"
+#include "uci_engine.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string_view>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const std::chrono::milliseconds SearchTimeout(300000);
+    // engine output is read in slices this long so a shutdown is noticed mid-search
+    const std::chrono::milliseconds PollSlice(20);
+    // how long an engine gets to answer stop (deadline or shutdown) before it is killed
+    const std::chrono::milliseconds StopGrace(2000);
+    // engine jobs each I/O thread may have waiting, per engine; past that sessions are parked
+    const std::size_t LaneDepthPerEngine = 4;
+    // a client that sends a longer line is not speaking the protocol
+    const std::size_t MaxLineLength = 256;
+    // replies a slow reader has not collected before the server stops reading from it
+    const std::size_t MaxPendingOutput = 16 * 1024;
+    const int MaxEvents = 256;
+    const int TickMs = 100;
+
+    // epoll user data for the two non-session descriptors of an I/O thread
+    const std::uint64_t ListenerTag = ~std::uint64_t(0);
+    const std::uint64_t WakeTag = ~std::uint64_t(0) - 1;
+
+    std::atomic<bool> stopRequested{false};
+
+    void onSignal(int)
+    {
+        stopRequested.store(true, std::memory_order_relaxed);
+    }
+
+    // One engine move to compute, and where to deliver it
+    struct EngineJob
+    {
+        std::size_t thread = 0;
+        std::uint32_t session = 0;
+        std::uint32_t generation = 0;
+        std::uint64_t key = 0;
+        std::string position;
+    };
+
+    struct EngineDone
+    {
+        std::uint32_t session = 0;
+        std::uint32_t generation = 0;
+        bool ok = false;
+        std::string bestmove;
+        std::string error;
+    };
+
+    // Per-connection game state; slots are reused, so generation tells a live session from a stale reply
+    struct Session
+    {
+        int fd = -1;
+        std::uint32_t generation = 0;
+        std::uint32_t events = 0;   // epoll interest currently registered
+        bool searching = false;     // an engine move is queued or running; input waits until it is sent
+        bool closing = false;       // close once the output is flushed
+        bool eof = false;           // client shut its write side; answer what it sent, then close
+        Game game;
+        std::string in;
+        std::string out;
+    };
+
+    // Fixed block of sessions allocated up front; accepting a connection only pops the free list
+    class SessionArena
+    {
+    public:
+        // Input: number of sessions
+        explicit SessionArena(std::size_t capacity) : slots(capacity)
+        {
+            freeList.reserve(capacity);
+            for (std::size_t i = capacity; i > 0; i--)
+                freeList.push_back(std::uint32_t(i - 1));
+        }
+
+        // Input: index to fill
+        // Output: false if every session is in use
+        bool acquire(std::uint32_t& index)
+        {
+            if (freeList.empty())
+                return false;
+            index = freeList.back();
+            freeList.pop_back();
+            return true;
+        }
+
+        // Resets a session for its next connection
+        // Input: index
+        // Output: None
+        void release(std::uint32_t index)
+        {
+            Session& s = slots[index];
+            s.fd = -1;
+            s.generation++;
+            s.events = 0;
+            s.searching = false;
+            s.closing = false;
+            s.eof = false;
+            s.game = Game();
+            s.in.clear();
+            s.out.clear();
+            // a rare burst should not pin memory for the life of the slot
+            if (s.out.capacity() > MaxPendingOutput)
+                s.out.shrink_to_fit();
+            freeList.push_back(index);
+        }
+
+        Session& operator[](std::uint32_t index) { return slots[index]; }
+        std::size_t inUse() const { return slots.size() - freeList.size(); }
+
+    private:
+        std::vector<Session> slots;
+        std::vector<std::uint32_t> freeList;
+    };
+
+    // Engine jobs in one bounded FIFO lane per I/O thread. Engines take lanes round-robin, so a
+    // busy thread cannot starve the others, and a session has at most one job, so within a lane
+    // sessions are served in turn.
+    class FairJobQueue
+    {
+    public:
+        // Input: number of lanes, max jobs per lane
+        FairJobQueue(std::size_t lanes, std::size_t laneCapacity) : lanes(lanes), laneCapacity(laneCapacity) {}
+
+        // Input: job (moved from only on success)
+        // Output: false if its lane is full or the queue is closed
+        bool tryPush(EngineJob& job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                std::deque<EngineJob>& lane = lanes[job.thread];
+                if (closed || lane.size() >= laneCapacity)
+                    return false;
+                lane.push_back(std::move(job));
+            }
+            notEmpty.notify_one();
+            return true;
+        }
+
+        // Takes the next job, blocking while there is none
+        // Input: job to fill
+        // Output: false once the queue is closed
+        bool pop(EngineJob& job)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                if (closed)
+                    return false;
+                for (std::size_t i = 0; i < lanes.size(); i++)
+                {
+                    std::deque<EngineJob>& lane = lanes[(next + i) % lanes.size()];
+                    if (lane.empty())
+                        continue;
+                    job = std::move(lane.front());
+                    lane.pop_front();
+                    next = (next + i + 1) % lanes.size();
+                    return true;
+                }
+                notEmpty.wait(lock);
+            }
+        }
+
+        // Drops waiting jobs and wakes every engine worker
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+            }
+            notEmpty.notify_all();
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable notEmpty;
+        std::vector<std::deque<EngineJob>> lanes;
+        std::size_t laneCapacity;
+        std::size_t next = 0;
+        bool closed = false;
+    };
+
+    // Totals reported at shutdown
+    struct ServerStats
+    {
+        std::atomic<std::uint64_t> accepted{0};
+        std::atomic<std::uint64_t> rejected{0};
+        std::atomic<std::uint64_t> moves{0};
+        std::atomic<std::uint64_t> cacheHits{0};
+        std::atomic<std::uint64_t> parked{0};
+    };
+
+    // Runs one search, sending stop at the plan's deadline or once the server is shutting down
+    // Input: engine, position command, search plan
+    // Output: SearchResult (throws UciError on engine failure or when stop goes unanswered)
+    SearchResult searchMove(UciEngine& engine, const std::string& position, const SearchPlan& plan)
+    {
+        SearchResult result;
+        engine.send(position);
+        const auto start = Clock::now();
+        engine.send(plan.go);
+        const UciCommand command = engine.lastCommand();
+        auto giveUp = start + std::max(plan.deadline, SearchTimeout);
+        const auto stopAt = plan.deadline.count() > 0 ? start + plan.deadline : giveUp;
+        bool stopSent = false;
+        auto onLine = [&](std::string_view line)
+        {
+            if (parseBestMoveLine(line, result))
+                return true;
+            parseInfoLine(line, result);
+            return false;
+        };
+
+        // the last slice before the deadline is cut short so stop goes out on time
+        auto slice = [&]
+        {
+            if (stopSent)
+                return PollSlice;
+            const auto left = std::chrono::ceil<std::chrono::milliseconds>(stopAt - Clock::now());
+            return std::clamp(left, std::chrono::milliseconds(0), PollSlice);
+        };
+
+        while (!engine.poll(slice(), onLine))
+        {
+            const auto now = Clock::now();
+            if (!stopSent && (now >= stopAt || stopRequested.load(std::memory_order_relaxed)))
+            {
+                engine.send("stop");
+                stopSent = true;
+                giveUp = std::min(giveUp, now + StopGrace);
+            }
+            if (now >= giveUp)
+            {
+                metrics().timeouts.fetch_add(1, std::memory_order_relaxed);
+                throw UciError("timed out waiting for engine");
+            }
+        }
+
+        const auto elapsed = Clock::now() - start;
+        metrics().wait[std::size_t(command)].record(elapsed);
+        metrics().recordSearch(result, elapsed);
+        return result;
+    }
+
+    // Opens a non-blocking listener that shares its port with the other I/O threads
+    // Input: port
+    // Output: socket (throws std::runtime_error on failure)
+    int openListener(int port)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(std::uint16_t(port));
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0)
+        {
+            std::string error = std::strerror(errno);
+            ::close(fd);
+            throw std::runtime_error("port " + std::to_string(port) + ": " + error);
+        }
+        return fd;
+    }
+
+    // One epoll loop owning a listener and a share of the sessions; nothing in it is shared
+    // except the mailbox engine workers post finished moves to
+    class IoThread
+    {
+    public:
+        IoThread(std::size_t id, int listenFd, std::size_t capacity, FairJobQueue& jobs, AnalysisCache& cache,
+                 const SearchPlan& plan, ServerStats& stats)
+            : id(id), listenFd(listenFd), arena(capacity), jobs(jobs), cache(cache), plan(plan), stats(stats)
+        {
+            epollFd = epoll_create1(EPOLL_CLOEXEC);
+            wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (epollFd < 0 || wakeFd < 0)
+                throw std::runtime_error(std::string("epoll: ") + std::strerror(errno));
+            watch(listenFd, EPOLLIN, ListenerTag);
+            watch(wakeFd, EPOLLIN, WakeTag);
+        }
+
+        ~IoThread()
+        {
+            for (std::uint32_t i = 0; arena.inUse() > 0; i++)
+            {
+                if (arena[i].fd >= 0)
+                    closeSession(i);
+            }
+            ::close(wakeFd);
+            ::close(epollFd);
+            ::close(listenFd);
+        }
+
+        IoThread(const IoThread&) = delete;
+        IoThread& operator=(const IoThread&) = delete;
+
+        // Hands a finished move back to this thread; called from engine workers
+        // Input: result
+        // Output: None
+        void complete(EngineDone done)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mailboxMutex);
+                mailbox.push_back(std::move(done));
+            }
+            wake();
+        }
+
+        // Lets parked sessions take the lane space a worker just freed, instead of waiting for
+        // the next tick; called from engine workers after they pop one of this thread's jobs
+        void laneFreed()
+        {
+            if (hasParked.load())
+                wake();
+        }
+
+        // Serves connections until a stop is requested
+        void run()
+        {
+            epoll_event events[MaxEvents];
+            while (!stopRequested.load(std::memory_order_relaxed))
+            {
+                int n = epoll_wait(epollFd, events, MaxEvents, TickMs);
+                for (int i = 0; i < n; i++)
+                {
+                    const std::uint64_t tag = events[i].data.u64;
+                    if (tag == ListenerTag)
+                        acceptAll();
+                    else if (tag == WakeTag)
+                        drainMailbox();
+                    else
+                        onSessionEvent(std::uint32_t(tag), events[i].events);
+                }
+                retryParked();
+            }
+        }
+
+    private:
+        void wake()
+        {
+            std::uint64_t one = 1;
+            (void)!::write(wakeFd, &one, sizeof(one));
+        }
+
+        void watch(int fd, std::uint32_t events, std::uint64_t tag)
+        {
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.u64 = tag;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        }
+
+        void acceptAll()
+        {
+            while (true)
+            {
+                int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                    return;
+
+                std::uint32_t index;
+                if (!arena.acquire(index))
+                {
+                    static const char full[] = "error server full\n";
+                    (void)!::send(fd, full, sizeof(full) - 1, MSG_NOSIGNAL);
+                    ::close(fd);
+                    stats.rejected.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                // replies are single short lines; don't let Nagle hold them back
+                int on = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+                Session& s = arena[index];
+                s.fd = fd;
+                s.events = EPOLLIN;
+                watch(fd, EPOLLIN, index);
+                stats.accepted.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void onSessionEvent(std::uint32_t index, std::uint32_t events)
+        {
+            Session& s = arena[index];
+            if (s.fd < 0)
+                return;
+            if (events & (EPOLLERR | EPOLLHUP))
+            {
+                closeSession(index);
+                return;
+            }
+            if (events & EPOLLOUT)
+                flush(s);
+            if (events & EPOLLIN)
+            {
+                char buf[4096];
+                ssize_t n = recv(s.fd, buf, sizeof(buf), 0);
+                if (n < 0 && errno != EAGAIN && errno != EINTR)
+                {
+                    closeSession(index);
+                    return;
+                }
+                if (n == 0)
+                    s.eof = true;
+                else if (n > 0)
+                    s.in.append(buf, std::size_t(n));
+                processInput(index);
+            }
+            finish(index);
+        }
+
+        // Runs buffered commands until one has to wait for the engine
+        void processInput(std::uint32_t index)
+        {
+            Session& s = arena[index];
+            std::size_t start = 0;
+            while (!s.searching && !s.closing)
+            {
+                std::size_t end = s.in.find('\n', start);
+                if (end == std::string::npos)
+                    break;
+                std::string_view line(s.in.data() + start, end - start);
+                if (!line.empty() && line.back() == '\r')
+                    line.remove_suffix(1);
+                handleCommand(index, line);
+                start = end + 1;
+            }
+            s.in.erase(0, start);
+
+            if (s.in.size() > MaxLineLength && s.in.find('\n') == std::string::npos)
+            {
+                s.out += "error line too long\n";
+                s.closing = true;
+            }
+        }
+
+        void handleCommand(std::uint32_t index, std::string_view line)
+        {
+            Session& s = arena[index];
+            if (line == "new")
+            {
+                s.game = Game();
+                s.out += "ok\n";
+            }
+            else if (line.substr(0, 5) == "move ")
+            {
+                if (!s.game.play(std::string(line.substr(5))))
+                    s.out += "illegal\n";
+                else if (getLegalMoves(s.game.position()).empty())
+                    s.out += "gameover\n";
+                else
+                    requestMove(index);
+            }
+            else if (line == "quit")
+            {
+                s.closing = true;
+            }
+            else if (!line.empty())
+            {
+                s.out += "error unknown command\n";
+            }
+        }
+
+        // Answers from the cache or queues a search; a full lane parks the session
+        void requestMove(std::uint32_t index)
+        {
+            Session& s = arena[index];
+            SearchResult cached;
+            if (cache.isOpen() && cache.probe(s.game.position().key(), cached) && cached.depth >= plan.cacheDepth)
+            {
+                stats.cacheHits.fetch_add(1, std::memory_order_relaxed);
+                playReply(s, cached.bestmove);
+                return;
+            }
+
+            // newcomers queue behind parked sessions so lane space goes first-come first-served
+            s.searching = true;
+            if (!parked.empty() || !submit(index))
+            {
+                parked.push_back({index, s.generation});
+                stats.parked.fetch_add(1, std::memory_order_relaxed);
+                // publish before retrying: a worker that frees space after the retry sees the flag
+                hasParked.store(true);
+                retryParked();
+            }
+        }
+
+        bool submit(std::uint32_t index)
+        {
+            Session& s = arena[index];
+            EngineJob job;
+            job.thread = id;
+            job.session = index;
+            job.generation = s.generation;
+            job.key = s.game.position().key();
+            job.position = s.game.uciPosition();
+            return jobs.tryPush(job);
+        }
+
+        // Parked sessions go first-come first-served as lane space frees up
+        void retryParked()
+        {
+            while (!parked.empty())
+            {
+                const auto [index, generation] = parked.front();
+                if (arena[index].fd >= 0 && arena[index].generation == generation && !submit(index))
+                    return;
+                parked.pop_front();
+            }
+            hasParked.store(false);
+        }
+
+        void drainMailbox()
+        {
+            std::uint64_t count;
+            (void)!::read(wakeFd, &count, sizeof(count));
+            {
+                std::lock_guard<std::mutex> lock(mailboxMutex);
+                std::swap(mailbox, delivered);
+            }
+
+            for (EngineDone& done : delivered)
+            {
+                Session& s = arena[done.session];
+                if (s.fd < 0 || s.generation != done.generation)
+                    continue;   // the client left while its move was searching
+
+                s.searching = false;
+                if (done.ok)
+                    playReply(s, done.bestmove);
+                else
+                    s.out += "error " + done.error + "\n";
+                processInput(done.session);
+                finish(done.session);
+            }
+            delivered.clear();
+        }
+
+        void playReply(Session& s, const std::string& bestmove)
+        {
+            if (s.game.play(bestmove))
+            {
+                s.out += "bestmove " + bestmove;
+                s.out += getLegalMoves(s.game.position()).empty() ? " gameover\n" : "\n";
+                stats.moves.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                s.out += "error engine returned " + bestmove + "\n";
+            }
+        }
+
+        void flush(Session& s)
+        {
+            std::size_t sent = 0;
+            while (sent < s.out.size())
+            {
+                ssize_t n = ::send(s.fd, s.out.data() + sent, s.out.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0)
+                    break;
+                sent += std::size_t(n);
+            }
+            s.out.erase(0, sent);
+        }
+
+        // Writes what it can, then reads only while the session may take another command
+        // and the client is collecting its replies
+        void finish(std::uint32_t index)
+        {
+            Session& s = arena[index];
+            if (s.fd < 0)
+                return;
+            flush(s);
+            if (s.eof && !s.searching && s.in.find('\n') == std::string::npos)
+                s.closing = true;
+            if (s.closing && s.out.empty())
+            {
+                closeSession(index);
+                return;
+            }
+
+            std::uint32_t want = 0;
+            if (!s.searching && !s.closing && !s.eof && s.out.size() < MaxPendingOutput)
+                want |= EPOLLIN;
+            if (!s.out.empty())
+                want |= EPOLLOUT;
+            if (want != s.events)
+            {
+                epoll_event ev{};
+                ev.events = want;
+                ev.data.u64 = index;
+                epoll_ctl(epollFd, EPOLL_CTL_MOD, s.fd, &ev);
+                s.events = want;
+            }
+        }
+
+        void closeSession(std::uint32_t index)
+        {
+            ::close(arena[index].fd);
+            arena.release(index);
+        }
+
+        std::size_t id;
+        int listenFd;
+        int epollFd = -1;
+        int wakeFd = -1;
+        SessionArena arena;
+        FairJobQueue& jobs;
+        AnalysisCache& cache;
+        const SearchPlan& plan;
+        ServerStats& stats;
+
+        std::deque<std::pair<std::uint32_t, std::uint32_t>> parked;  // index, generation
+        std::atomic<bool> hasParked{false};
+
+        std::mutex mailboxMutex;
+        std::vector<EngineDone> mailbox;
+        std::vector<EngineDone> delivered;  // only touched by this thread
+    };
+}
+
+// Serves games until SIGINT or SIGTERM
+// Input: ServerOptions
+// Output: process exit code
+int runServer(const ServerOptions& options)
+{
+    const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t ioThreads = options.ioThreads > 0 ? options.ioThreads : std::max<std::size_t>(1, cores / 8);
+    const std::size_t engines = options.engines > 0 ? options.engines : cores;
+
+    AnalysisCache cache;
+    if (!options.cachePath.empty())
+        cache.open(options.cachePath, options.cacheSizeMB);
+
+    const int hashMB = options.hashMB > 0 ? options.hashMB : recommendedHashMB(engines);
+    EnginePool pool(options.enginePath, engines,
+                    {"setoption name Threads value 1", "setoption name Hash value " + std::to_string(hashMB)});
+    FairJobQueue jobs(ioThreads, engines * LaneDepthPerEngine);
+    ServerStats stats;
+
+    std::vector<std::unique_ptr<IoThread>> io;
+    try
+    {
+        const std::size_t perThread = (options.maxSessions + ioThreads - 1) / ioThreads;
+        for (std::size_t i = 0; i < ioThreads; i++)
+            io.push_back(std::make_unique<IoThread>(i, openListener(options.port), perThread, jobs, cache,
+                                                    options.plan, stats));
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << "Server failed to start: " << e.what() << "\n";
+        return 1;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    console() << "Serving on port " << options.port << " with " << ioThreads << " I/O threads, " << engines
+              << " engines (" << options.plan.go << ")\n" << std::flush;
+    const auto start = Clock::now();
+
+    std::vector<std::thread> workers;
+    for (std::size_t slot = 0; slot < engines; slot++)
+    {
+        workers.emplace_back([&, slot]
+        {
+            EngineJob job;
+            while (jobs.pop(job))
+            {
+                io[job.thread]->laneFreed();
+                EngineDone done;
+                done.session = job.session;
+                done.generation = job.generation;
+                try
+                {
+                    SearchResult r = pool.withEngine(slot, [&](UciEngine& engine)
+                    {
+                        return searchMove(engine, job.position, options.plan);
+                    });
+                    if (cache.isOpen())
+                        cache.store(job.key, r);
+                    done.ok = true;
+                    done.bestmove = std::move(r.bestmove);
+                }
+                catch (const UciError& e)
+                {
+                    done.error = e.what();
+                }
+                io[job.thread]->complete(std::move(done));
+            }
+        });
+    }
+
+    std::vector<std::thread> loops;
+    for (std::unique_ptr<IoThread>& t : io)
+        loops.emplace_back(&IoThread::run, t.get());
+    for (std::thread& t : loops)
+        t.join();
+
+    // sessions are gone, so waiting jobs are dropped; searches in progress get stop (workers see
+    // stopRequested) and an engine that ignores it is killed rather than restarted
+    pool.shutdown();
+    jobs.close();
+    for (std::thread& t : workers)
+        t.join();
+
+    double secs = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cerr << "Served " << stats.accepted.load() << " sessions (" << stats.rejected.load() << " refused), "
+              << stats.moves.load() << " moves in " << secs << " s (" << (secs > 0 ? stats.moves.load() / secs : 0.0)
+              << " moves/s, " << stats.cacheHits.load() << " from cache, " << stats.parked.load() << " parked, "
+              << pool.restarts() << " restarts)\n";
+    return 0;
+}
@@ -0,0 +1,41 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Headless TCP server that plays many games at once over a shared engine pool
+*/
+
+#pragma once
+
+#include "search_policy.h"
+
+#include <cstddef>
+#include <string>
+
+// Line protocol, one reply line per command. Commands may be pipelined: each is answered in
+// order, and one sent while a move is searching waits for that reply.
+//   new          -> ok                 starts a fresh game, the client plays White
+//   move e2e4    -> bestmove e7e5      the engine's answer, already played on the server's board
+//                   bestmove d8h4 gameover    ... and it ended the game
+//                   gameover           the client's move ended the game
+//                   illegal            move rejected, position unchanged
+//                   error <reason>
+//   quit         -> (connection closed once earlier replies are sent; so does closing the write side)
+struct ServerOptions
+{
+    int port = 7777;
+    std::size_t ioThreads = 0;      // 0 picks one per 8 cores
+    std::size_t engines = 0;        // 0 picks one per core
+    std::size_t maxSessions = 4096; // shared between the I/O threads
+    std::string enginePath = "../src/stockfish";
+    int hashMB = 0;                 // per engine; 0 sizes it from free memory
+    SearchPlan plan;                // go command for every engine move
+
+    std::string cachePath = "analysis.cache";   // empty disables the cache
+    std::size_t cacheSizeMB = 64;
+};
+
+// Serves games until SIGINT or SIGTERM
+// Input: ServerOptions
+// Output: process exit code
+int runServer(const ServerOptions& options);
@@ -0,0 +1,151 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Bounded lock-free single-producer/single-consumer queues
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+// Exactly one thread may push and exactly one (other) thread may pop
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer side
+    // Input: item
+    // Output: false if the queue is full (item is left untouched)
+    bool push(T&& item)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache >= Capacity)
+        {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache >= Capacity)
+                return false;
+        }
+        slots[t & (Capacity - 1)] = std::move(item);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& item)
+    {
+        T copy = item;
+        return push(std::move(copy));
+    }
+
+    // Consumer side
+    // Input: slot to receive the item
+    // Output: false if the queue is empty
+    bool pop(T& out)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache)
+        {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache)
+                return false;
+        }
+        out = std::move(slots[h & (Capacity - 1)]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    // Input: None
+    // Output: true if there is nothing to pop
+    bool empty() const
+    {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
+    // Producer side
+    // Input: None
+    // Output: true if push would fail
+    bool full() const
+    {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) >= Capacity;
+    }
+
+private:
+    // producer and consumer indices live on separate cache lines, each with
+    // a private copy of the other side's index to avoid needless cross-core reads
+    alignas(64) std::atomic<std::size_t> head{0};
+    std::size_t tailCache = 0;
+
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::size_t headCache = 0;
+
+    alignas(64) std::array<T, Capacity> slots{};
+};
+
+// Byte stream variant: copies runs of bytes instead of moving one item at a time
+template <std::size_t Capacity>
+class SpscByteQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer side
+    // Input: bytes to append
+    // Output: number of bytes accepted (less than len when the queue fills up)
+    std::size_t write(const char* data, std::size_t len)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (Capacity - (t - headCache) < len)
+            headCache = head.load(std::memory_order_acquire);
+        const std::size_t n = std::min(len, Capacity - (t - headCache));
+
+        const std::size_t at = t & (Capacity - 1);
+        const std::size_t first = std::min(n, Capacity - at);
+        std::memcpy(bytes.data() + at, data, first);
+        std::memcpy(bytes.data(), data + first, n - first);
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side
+    // Input: destination buffer and its size
+    // Output: number of bytes copied (0 when the queue is empty)
+    std::size_t read(char* out, std::size_t cap)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (tailCache - h < cap)
+            tailCache = tail.load(std::memory_order_acquire);
+        const std::size_t n = std::min(cap, tailCache - h);
+
+        const std::size_t at = h & (Capacity - 1);
+        const std::size_t first = std::min(n, Capacity - at);
+        std::memcpy(out, bytes.data() + at, first);
+        std::memcpy(out + first, bytes.data(), n - first);
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side
+    // Input: None
+    // Output: true if there is nothing to read
+    bool empty() const
+    {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<std::size_t> head{0};
+    std::size_t tailCache = 0;
+
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::size_t headCache = 0;
+
+    alignas(64) std::array<char, Capacity> bytes{};
+};
@@ -0,0 +1,172 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Non-blocking UCI client that frames engine output into lines over any transport
+*/
+
+#include "uci_engine.h"
+#include "engine_transport.h"
+
+#include <cstring>
+
+UciEngine::UciEngine() = default;
+
+UciEngine::~UciEngine()
+{
+    try
+    {
+        stop();
+    }
+    catch (const UciError&)
+    {
+    }
+}
+
+// Forks and execs the engine binary at path
+// Input: std::string path to executable
+// Output: None (throws UciError on failure)
+void UciEngine::start(const std::string& path)
+{
+    stop();
+    start(std::make_unique<PipeTransport>(path));
+}
+
+// Attaches an already started engine, replacing any current one
+// Input: transport
+// Output: None
+void UciEngine::start(std::unique_ptr<EngineTransport> next)
+{
+    stop();
+    transport = std::move(next);
+}
+
+// Asks the engine to quit and releases it
+// Input: None
+// Output: None
+void UciEngine::stop()
+{
+    if (transport)
+    {
+        transport->close();
+        transport.reset();
+    }
+    head = scan = tail = 0;
+}
+
+// Writes a full command to the engine, appending a newline if missing
+// Input: std::string command
+// Output: None (throws UciError if the engine is gone)
+void UciEngine::send(const std::string& cmd)
+{
+    if (!transport)
+        throw UciError("engine is not running");
+
+    const auto start = std::chrono::steady_clock::now();
+    last = classifyCommand(cmd);
+    if (!cmd.empty() && cmd.back() == '\n')
+        transport->write(cmd.data(), cmd.size());
+    else
+    {
+        std::string line = cmd;
+        line += '\n';
+        transport->write(line.data(), line.size());
+    }
+    metrics().send[std::size_t(last)].record(std::chrono::steady_clock::now() - start);
+}
+
+// Feeds complete output lines to onLine until it returns true
+// Input: timeout for the whole command, line callback
+// Output: None (throws UciError on EOF or when the deadline passes)
+void UciEngine::readLines(std::chrono::milliseconds timeout, const LineHandler& onLine)
+{
+    const auto start = std::chrono::steady_clock::now();
+    if (!readLinesBefore(start + timeout, onLine))
+    {
+        metrics().timeouts.fetch_add(1, std::memory_order_relaxed);
+        throw UciError("timed out waiting for engine");
+    }
+    metrics().wait[std::size_t(last)].record(std::chrono::steady_clock::now() - start);
+}
+
+// Feeds whatever lines arrive within wait to onLine; a quiet engine is not an error
+// Input: how long to wait, line callback
+// Output: true if onLine stopped reading (throws UciError on EOF)
+bool UciEngine::poll(std::chrono::milliseconds wait, const LineHandler& onLine)
+{
+    return readLinesBefore(std::chrono::steady_clock::now() + wait, onLine);
+}
+
+bool UciEngine::readLinesBefore(std::chrono::steady_clock::time_point deadline, const LineHandler& onLine)
+{
+    if (!transport)
+        throw UciError("engine is not running");
+
+    while (true)
+    {
+        // hand out every complete line, scanning only bytes not seen before
+        while (scan < tail)
+        {
+            const void* nl = std::memchr(buf.data() + scan, '\n', tail - scan);
+            if (!nl)
+            {
+                scan = tail;
+                break;
+            }
+
+            std::size_t end = static_cast<const char*>(nl) - buf.data();
+            std::size_t len = end - head;
+            if (len > 0 && buf[head + len - 1] == '\r')
+                len--;
+
+            std::string_view line(buf.data() + head, len);
+            head = scan = end + 1;
+            if (onLine(line))
+                return true;
+        }
+
+        // keep the partial line at the front so the buffer never grows
+        if (head == tail)
+        {
+            head = scan = tail = 0;
+        }
+        else if (tail == buf.size())
+        {
+            if (head == 0)
+            {
+                // single line longer than the buffer: pass it on in pieces
+                std::string_view line(buf.data(), tail);
+                head = scan = tail = 0;
+                if (onLine(line))
+                    return true;
+                continue;
+            }
+            std::memmove(buf.data(), buf.data() + head, tail - head);
+            tail -= head;
+            scan -= head;
+            head = 0;
+        }
+
+        std::size_t n = transport->read(buf.data() + tail, buf.size() - tail, deadline);
+        if (n == 0)
+            return false;
+
+        tail += n;
+    }
+}
+
+// Reads until a line starting with keyword arrives
+// Input: keyword, timeout
+// Output: copy of the matching line
+std::string UciEngine::readUntil(std::string_view keyword, std::chrono::milliseconds timeout)
+{
+    std::string match;
+    readLines(timeout, [&](std::string_view line)
+    {
+        if (line.substr(0, keyword.size()) != keyword)
+            return false;
+        match.assign(line);
+        return true;
+    });
+    return match;
+}
@@ -0,0 +1,100 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Non-blocking UCI client that frames engine output into lines over any transport
+*/
+
+#pragma once
+
+#include "metrics.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+class EngineTransport;
+
+// Raised when the engine dies, closes its pipe or misses a deadline
+class UciError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Owns one engine connection and frames its output into lines
+class UciEngine
+{
+public:
+    // Called once per output line; return true to stop reading
+    using LineHandler = std::function<bool(std::string_view)>;
+
+    UciEngine();
+    ~UciEngine();
+
+    UciEngine(const UciEngine&) = delete;
+    UciEngine& operator=(const UciEngine&) = delete;
+
+    // Forks and execs the engine binary at path
+    // Input: std::string path to executable
+    // Output: None (throws UciError on failure)
+    void start(const std::string& path);
+
+    // Attaches an already started engine, replacing any current one
+    // Input: transport
+    // Output: None
+    void start(std::unique_ptr<EngineTransport> transport);
+
+    // Asks the engine to quit and releases it
+    // Input: None
+    // Output: None
+    void stop();
+
+    // Input: None
+    // Output: true while an engine is attached
+    bool running() const { return transport != nullptr; }
+
+    // Writes a full command to the engine, appending a newline if missing
+    // Input: std::string command
+    // Output: None (throws UciError if the pipe is broken)
+    void send(const std::string& cmd);
+
+    // Feeds complete output lines to onLine until it returns true
+    // Input: timeout for the whole command, line callback
+    // Output: None (throws UciError on EOF or when the deadline passes)
+    void readLines(std::chrono::milliseconds timeout, const LineHandler& onLine);
+
+    // Feeds whatever lines arrive within wait to onLine; a quiet engine is not an error
+    // Input: how long to wait, line callback
+    // Output: true if onLine stopped reading (throws UciError on EOF)
+    bool poll(std::chrono::milliseconds wait, const LineHandler& onLine);
+
+    // Reads until a line starting with keyword arrives
+    // Input: keyword, timeout
+    // Output: copy of the matching line
+    std::string readUntil(std::string_view keyword, std::chrono::milliseconds timeout);
+
+    // Input: None
+    // Output: type of the last command sent; waits are attributed to it in metrics()
+    UciCommand lastCommand() const { return last; }
+
+private:
+    static constexpr std::size_t BufferSize = 1 << 16;
+
+    // Output: true if onLine stopped reading, false once the deadline passed
+    bool readLinesBefore(std::chrono::steady_clock::time_point deadline, const LineHandler& onLine);
+
+    std::unique_ptr<EngineTransport> transport;
+    UciCommand last = UciCommand::Other;
+
+    // Fixed read buffer: [head, tail) holds unconsumed bytes, [head, scan) has no newline
+    std::array<char, BufferSize> buf{};
+    std::size_t head = 0;
+    std::size_t scan = 0;
+    std::size_t tail = 0;
+};
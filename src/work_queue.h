@@ -0,0 +1,128 @@
+/*
+Author: Andrew Chen
+Class: ECE6122
+Last Date Modified: 10/16/2026
+Description: Bounded work-stealing queue shared by a fixed set of worker threads
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+// Each worker pops from the front of its own lane and steals from the back of others
+template <typename T>
+class WorkStealingQueue
+{
+public:
+    // Input: number of worker lanes, max items queued before push blocks
+    WorkStealingQueue(std::size_t workers, std::size_t capacity)
+        : lanes(new Lane[workers]), laneCount(workers), capacity(capacity)
+    {
+    }
+
+    // Adds an item to the next lane round-robin, blocking while the queue is full
+    // Input: item
+    // Output: false if the queue was closed
+    bool push(T item)
+    {
+        {
+            std::unique_lock<std::mutex> lock(waitMutex);
+            notFull.wait(lock, [&] { return count < capacity || closed; });
+            if (closed)
+                return false;
+            count++;
+        }
+
+        Lane& lane = lanes[nextLane];
+        nextLane = (nextLane + 1) % laneCount;
+        {
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            lane.items.push_back(std::move(item));
+        }
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Wakes every waiting worker; pop drains what is left and then returns false
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(waitMutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    // Takes the next item for a worker, stealing when its own lane is empty
+    // Input: worker index, output slot
+    // Output: false once the queue is closed and empty
+    bool pop(std::size_t worker, T& out)
+    {
+        while (true)
+        {
+            if (tryTake(worker, out))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(waitMutex);
+                    count--;
+                }
+                notFull.notify_one();
+                return true;
+            }
+
+            // count covers items still being pushed, so re-check before sleeping
+            std::unique_lock<std::mutex> lock(waitMutex);
+            if (count == 0 && closed)
+                return false;
+            if (count == 0)
+                notEmpty.wait(lock, [&] { return count > 0 || closed; });
+        }
+    }
+
+private:
+    struct Lane
+    {
+        std::mutex mutex;
+        std::deque<T> items;
+    };
+
+    bool tryTake(std::size_t worker, T& out)
+    {
+        for (std::size_t i = 0; i < laneCount; i++)
+        {
+            Lane& lane = lanes[(worker + i) % laneCount];
+            std::lock_guard<std::mutex> lock(lane.mutex);
+            if (lane.items.empty())
+                continue;
+
+            if (i == 0)
+            {
+                out = std::move(lane.items.front());
+                lane.items.pop_front();
+            }
+            else
+            {
+                out = std::move(lane.items.back());
+                lane.items.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    std::unique_ptr<Lane[]> lanes;
+    std::size_t laneCount;
+    std::size_t capacity;
+    std::size_t nextLane = 0;   // only touched by the single producer
+
+    std::mutex waitMutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::size_t count = 0;
+    bool closed = false;
+};